@@ -1,6 +1,10 @@
 #ifndef ARENA_H
 #define ARENA_H
 
+#if defined(ARENA_IMPLEMENTATION) && defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -8,359 +12,5890 @@
 #include <string.h>
 #include <stdint.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARENA_HAS_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_HOLE_BINS 32
+#define ARENA_HOLE_MIN_SIZE 16
+#define ARENA_SPARE_CHUNKS 4
+#define ARENA_SPARE_MIN_FREE 256
+#define ARENA_DEDICATED_DIVISOR 4
+#define ARENA_HUGE_THRESHOLD (4 * 1024 * 1024)
+#define ARENA_RETAIN_ALL SIZE_MAX
+#define ARENA_ADAPT_SHIFT 2
+#define ARENA_ADAPT_GRANULE 4096
+#define ARENA_SNAPSHOT_MAGIC "ARENASNP"
+#define ARENA_SNAPSHOT_VERSION 1
+#define ARENA_SNAPSHOT_ALIGN 4096
+#define ARENA_SNAPSHOT_PAGE 65536
+#define ARENA_FILE_MAGIC "ARENAFIL"
+#define ARENA_FILE_VERSION 1
+#define ARENA_SHARED_MAGIC "ARENASHM"
+#define ARENA_SHARED_VERSION 1
+#define ARENA_CHECKPOINT_MAGIC "ARENACKP"
+#define ARENA_CHECKPOINT_VERSION 4
+#define ARENA_CHECKPOINT_SLOT 512
+
 typedef struct Arena Arena;
 
+typedef enum ArenaMemoryKind {
+    ARENA_MEMORY_HEAP,
+    ARENA_MEMORY_MAPPED,
+    ARENA_MEMORY_RESERVED,
+    ARENA_MEMORY_FILE,
+    ARENA_MEMORY_CUSTOM
+} ArenaMemoryKind;
+
+typedef enum ArenaResizeResult {
+    ARENA_RESIZE_FAILED = 0,
+    ARENA_RESIZE_IN_PLACE,
+    ARENA_RESIZE_COMMITTED,
+    ARENA_RESIZE_APPENDED
+} ArenaResizeResult;
+
+typedef struct ArenaSiteProfile {
+    const char* name;
+    size_t usage_average;
+    size_t samples;
+} ArenaSiteProfile;
+
+#define ARENA_SITE_PROFILE(name) {name, 0, 0}
+
+typedef struct ArenaBacking {
+    void* (*reserve)(void* ctx, size_t size);
+    bool (*commit)(void* ctx, void* memory, size_t size);
+    void (*release)(void* ctx, void* memory, size_t size);
+    void* ctx;
+} ArenaBacking;
+
+typedef struct ArenaStaticBacking {
+    uint8_t* memory;
+    size_t size;
+    size_t used;
+    size_t live;
+} ArenaStaticBacking;
+
 typedef struct Arena {
     Arena* self;
     void* memory;
+    ArenaMemoryKind memory_kind;
+    uint64_t serial;
+    ArenaBacking backing;
+    size_t reserved;
     size_t size;
     size_t offset;
+    size_t high_offset;
     size_t peak_usage;
     Arena* next;
     Arena* head;
+    Arena* high_chunk;
+    Arena* active;
+    Arena* spares[ARENA_SPARE_CHUNKS];
+    size_t spare_count;
+    size_t base;
+    size_t next_base;
+    Arena* owner;
+    size_t owner_base;
+    size_t owner_mark;
+    size_t reuse_mark;
+    size_t reuse_base;
+    size_t reuse_offset;
+    void* huge;
+    size_t huge_count;
+    size_t huge_bytes;
+    size_t huge_threshold;
+    size_t retain_target;
+    size_t retain_decay_resets;
+    double retain_decay_ms;
+    size_t retain_limit;
+    double retain_stamp;
+    size_t released_bytes;
+    bool adaptive;
+    size_t usage_average;
+    ArenaSiteProfile* profile;
+    size_t snapshot_relocations;
+    void** snapshot_slots;
+    size_t snapshot_slot_count;
+    size_t snapshot_slot_capacity;
+    bool snapshot_scan;
+    int file_fd;
+    void* file_header;
+    bool file_private;
+    bool forkable;
+    bool frozen;
     size_t allocation_count;
     size_t total_allocated;
+    uint32_t hole_mask;
+    void* holes[ARENA_HOLE_BINS];
+    size_t hole_bytes;
+    size_t reclaimed_bytes;
+    bool bump_down;
+    bool contiguous;
 
     void* (*alloc)(Arena* self, size_t size);
     void* (*alloc_aligned)(Arena* self, size_t size, size_t alignment);
     void* (*realloc)(Arena* self, void* ptr, size_t old_size, size_t new_size);
+    bool (*free_last)(Arena* self, void* ptr, size_t size);
     void (*reset)(Arena* self);
     void (*reset_to_mark)(Arena* self, size_t mark);
     size_t (*get_mark)(Arena* self);
+    void* (*alloc_high)(Arena* self, size_t size);
+    void* (*alloc_high_aligned)(Arena* self, size_t size, size_t alignment);
+    void (*reset_high)(Arena* self);
+    void (*reset_high_to_mark)(Arena* self, size_t mark);
+    size_t (*get_high_mark)(Arena* self);
     void (*destroy)(Arena* self);
     void (*print_stats)(Arena* self);
-    bool (*resize)(Arena* self, size_t new_size);
+    ArenaResizeResult (*resize)(Arena* self, size_t new_size);
 } Arena;
 
 Arena* Arena_create(size_t size);
+Arena* Arena_create_bump_down(size_t size);
+Arena* Arena_create_contiguous(size_t size, size_t reserve);
+Arena* Arena_create_reserved(size_t size, size_t reserve);
+Arena* Arena_create_ex(size_t size, size_t reserve, const ArenaBacking* backing);
+ArenaBacking arena_backing_malloc(void);
+ArenaBacking arena_backing_mmap(void);
+ArenaBacking arena_backing_static(ArenaStaticBacking* state, void* memory, size_t size);
+Arena* Arena_create_adaptive(size_t size, ArenaSiteProfile* profile);
+Arena* Arena_create_from_snapshot(const char* path, void** root);
+bool arena_snapshot_save(Arena* arena, const void* root, const char* path);
+bool arena_snapshot_add_pointer(Arena* arena, void* slot);
+Arena* Arena_open_file(const char* path, size_t size, size_t max_size);
+Arena* Arena_create_forkable(size_t size, size_t max_size);
+Arena* arena_fork(Arena* arena);
+bool arena_freeze(Arena* arena, bool prefault);
+bool arena_sync(Arena* arena, const void* start, size_t length);
+void arena_file_set_root(Arena* arena, const void* root);
+void* arena_file_root(Arena* arena);
 
-#ifdef ARENA_IMPLEMENTATION
+#define ARENA_MAP_GROUP_WIDTH 16
+#define ARENA_MAP_EMPTY ((uint8_t)0x80)
+#define ARENA_MAP_DELETED ((uint8_t)0xFE)
 
-static void* arena_alloc(Arena* self, size_t size);
-static void* arena_alloc_aligned(Arena* self, size_t size, size_t alignment);
-static void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size);
-static void arena_reset(Arena* self);
-static void arena_reset_to_mark(Arena* self, size_t mark);
-static size_t arena_get_mark(Arena* self);
-static void arena_destroy(Arena* self);
-static void arena_print_stats(Arena* self);
-static bool arena_resize(Arena* self, size_t new_size);
+static inline uint64_t arena_hash_u64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
 
-static inline size_t align_forward(size_t ptr, size_t alignment) {
-    size_t modulo = ptr & (alignment - 1);
-    if (modulo != 0) {
-        ptr += alignment - modulo;
+static inline uint64_t arena_hash_bytes(const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
     }
-    return ptr;
+    return arena_hash_u64(hash);
 }
 
-static inline bool is_power_of_two(size_t x) {
-    return (x != 0) && ((x & (x - 1)) == 0);
+static inline uint64_t arena_hash_str(const char* str) {
+    return arena_hash_bytes(str, strlen(str));
 }
 
-Arena* Arena_create(size_t size) {
-    if (size == 0) {
-        fprintf(stderr, "Arena: Cannot create arena with size 0\n");
-        return NULL;
+static inline bool arena_str_eq(const char* a, const char* b) {
+    return strcmp(a, b) == 0;
+}
+
+static inline unsigned arena_ctz32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(x);
+#else
+    unsigned n = 0;
+    while ((x & 1u) == 0) {
+        x >>= 1;
+        n++;
     }
+    return n;
+#endif
+}
 
-    Arena* self = (Arena*)malloc(sizeof(Arena));
-    if (!self) {
-        fprintf(stderr, "Arena: Failed to allocate arena struct\n");
-        return NULL;
+static inline unsigned arena_clz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(x);
+#else
+    unsigned n = 0;
+    while ((x & 0x8000000000000000ULL) == 0) {
+        x <<= 1;
+        n++;
     }
+    return n;
+#endif
+}
 
-    self->memory = malloc(size);
-    if (!self->memory) {
-        fprintf(stderr, "Arena: Failed to allocate arena memory of size %zu\n", size);
-        free(self);
-        return NULL;
+static inline uint32_t arena_map_match(const uint8_t* group, uint8_t h2) {
+#ifdef ARENA_HAS_SSE2
+    __m128i ctrl = _mm_load_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < ARENA_MAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == h2) << i;
     }
+    return mask;
+#endif
+}
 
-    self->self = self;
-    self->size = size;
-    self->offset = 0;
-    self->peak_usage = 0;
-    self->next = NULL;
-    self->head = self;
-    self->allocation_count = 0;
-    self->total_allocated = 0;
-    self->alloc = arena_alloc;
-    self->alloc_aligned = arena_alloc_aligned;
-    self->realloc = arena_realloc;
-    self->reset = arena_reset;
-    self->reset_to_mark = arena_reset_to_mark;
-    self->get_mark = arena_get_mark;
-    self->destroy = arena_destroy;
-    self->print_stats = arena_print_stats;
-    self->resize = arena_resize;
+static inline uint32_t arena_map_match_empty(const uint8_t* group) {
+    return arena_map_match(group, ARENA_MAP_EMPTY);
+}
 
-    return self;
+static inline uint32_t arena_map_match_free(const uint8_t* group) {
+#ifdef ARENA_HAS_SSE2
+    return (uint32_t)_mm_movemask_epi8(_mm_load_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < ARENA_MAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
 }
 
-static void* arena_alloc(Arena* self, size_t size) {
-    if (!self || size == 0) {
-        return NULL;
+static inline size_t arena_map_capacity_for(size_t count) {
+    size_t capacity = ARENA_MAP_GROUP_WIDTH;
+    while (capacity - capacity / 8 < count) {
+        capacity *= 2;
     }
+    return capacity;
+}
 
-    if (self->offset + size <= self->size) {
-        void* ptr = (uint8_t*)self->memory + self->offset;
-        self->offset += size;
-        self->allocation_count++;
-        self->total_allocated += size;
+static inline size_t arena_map_table_bytes(size_t capacity, size_t entry_size) {
+    size_t bytes = capacity + capacity * entry_size;
+    return (bytes + ARENA_MAP_GROUP_WIDTH - 1) & ~(size_t)(ARENA_MAP_GROUP_WIDTH - 1);
+}
 
-        if (self->offset > self->peak_usage) {
-            self->peak_usage = self->offset;
+static inline size_t arena_map_find_free(const uint8_t* ctrl, size_t capacity, uint64_t hash) {
+    size_t group_mask = capacity / ARENA_MAP_GROUP_WIDTH - 1;
+    size_t group = (size_t)(hash >> 7) & group_mask;
+    for (size_t step = 1;; step++) {
+        uint32_t free_slots = arena_map_match_free(ctrl + group * ARENA_MAP_GROUP_WIDTH);
+        if (free_slots) {
+            return group * ARENA_MAP_GROUP_WIDTH + arena_ctz32(free_slots);
         }
+        group = (group + step) & group_mask;
+    }
+}
 
-        return ptr;
+static inline void arena_map_erase_slot(uint8_t* ctrl, size_t slot, size_t* growth_left) {
+    uint8_t* group = ctrl + (slot & ~(size_t)(ARENA_MAP_GROUP_WIDTH - 1));
+    if (arena_map_match_empty(group)) {
+        ctrl[slot] = ARENA_MAP_EMPTY;
+        (*growth_left)++;
+    } else {
+        ctrl[slot] = ARENA_MAP_DELETED;
     }
+}
 
-    size_t new_arena_size = self->size * 2;
-    if (new_arena_size < size) {
-        new_arena_size = size * 2;
+static inline void* arena_map_release_table(Arena* arena, void* old_table, size_t old_bytes,
+                                            void* new_table, size_t new_bytes) {
+    if (arena->free_last(arena->self, old_table, old_bytes)) {
+        return new_table;
     }
+    if ((uint8_t*)new_table == (uint8_t*)old_table + old_bytes &&
+        arena->free_last(arena->self, (uint8_t*)old_table + new_bytes, old_bytes)) {
+        memmove(old_table, new_table, new_bytes);
+        return old_table;
+    }
+    return new_table;
+}
 
-    Arena* new_chunk = Arena_create(new_arena_size);
-    if (!new_chunk) {
-        fprintf(stderr, "Arena: Failed to grow arena\n");
-        return NULL;
+#define ARENA_MAP_DEFINE(Name, K, V, hash_fn, eq_fn)                                              \
+    typedef struct Name##_entry {                                                                  \
+        K key;                                                                                     \
+        V value;                                                                                   \
+    } Name##_entry;                                                                                \
+                                                                                                   \
+    typedef struct Name Name;                                                                      \
+    struct Name {                                                                                  \
+        Name* self;                                                                                \
+        Arena* arena;                                                                              \
+        uint8_t* ctrl;                                                                             \
+        Name##_entry* entries;                                                                     \
+        size_t capacity;                                                                           \
+        size_t count;                                                                              \
+        size_t growth_left;                                                                        \
+        bool rewind_on_rehash;                                                                     \
+                                                                                                   \
+        V* (*get)(Name* self, K key);                                                              \
+        bool (*put)(Name* self, K key, V value);                                                   \
+        bool (*remove)(Name* self, K key);                                                         \
+        bool (*reserve)(Name* self, size_t count);                                                 \
+        void (*clear)(Name* self);                                                                 \
+        Name##_entry* (*next)(Name* self, size_t* cursor);                                         \
+    };                                                                                             \
+                                                                                                   \
+    static inline size_t Name##_find(Name* self, K key, uint64_t hash) {                           \
+        size_t group_mask = self->capacity / ARENA_MAP_GROUP_WIDTH - 1;                            \
+        size_t group = (size_t)(hash >> 7) & group_mask;                                           \
+        uint8_t h2 = (uint8_t)(hash & 0x7F);                                                       \
+        for (size_t step = 1; step <= group_mask + 1; step++) {                                    \
+            const uint8_t* ctrl = self->ctrl + group * ARENA_MAP_GROUP_WIDTH;                      \
+            uint32_t candidates = arena_map_match(ctrl, h2);                                       \
+            while (candidates) {                                                                   \
+                size_t slot = group * ARENA_MAP_GROUP_WIDTH + arena_ctz32(candidates);             \
+                if (eq_fn(self->entries[slot].key, key)) {                                         \
+                    return slot;                                                                   \
+                }                                                                                  \
+                candidates &= candidates - 1;                                                      \
+            }                                                                                      \
+            if (arena_map_match_empty(ctrl)) {                                                     \
+                break;                                                                             \
+            }                                                                                      \
+            group = (group + step) & group_mask;                                                   \
+        }                                                                                          \
+        return SIZE_MAX;                                                                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool Name##_rehash(Name* self, size_t capacity) {                                \
+        size_t bytes = arena_map_table_bytes(capacity, sizeof(Name##_entry));                      \
+        uint8_t* table = (uint8_t*)self->arena->alloc_aligned(self->arena->self, bytes,            \
+                                                              ARENA_MAP_GROUP_WIDTH);              \
+        if (!table) {                                                                              \
+            return false;                                                                          \
+        }                                                                                          \
+        memset(table, ARENA_MAP_EMPTY, capacity);                                                  \
+        Name##_entry* entries = (Name##_entry*)(table + capacity);                                 \
+        for (size_t i = 0; i < self->capacity; i++) {                                              \
+            if (self->ctrl[i] & 0x80) {                                                            \
+                continue;                                                                          \
+            }                                                                                      \
+            uint64_t hash = hash_fn(self->entries[i].key);                                         \
+            size_t slot = arena_map_find_free(table, capacity, hash);                              \
+            table[slot] = (uint8_t)(hash & 0x7F);                                                  \
+            entries[slot] = self->entries[i];                                                      \
+        }                                                                                          \
+        if (self->rewind_on_rehash && self->ctrl) {                                                \
+            size_t old_bytes = arena_map_table_bytes(self->capacity, sizeof(Name##_entry));        \
+            table = (uint8_t*)arena_map_release_table(self->arena, self->ctrl, old_bytes,          \
+                                                      table, bytes);                               \
+            entries = (Name##_entry*)(table + capacity);                                           \
+        }                                                                                          \
+        self->ctrl = table;                                                                        \
+        self->entries = entries;                                                                   \
+        self->capacity = capacity;                                                                 \
+        self->growth_left = capacity - capacity / 8 - self->count;                                 \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline V* Name##_get(Name* self, K key) {                                               \
+        if (!self || self->count == 0) {                                                           \
+            return NULL;                                                                           \
+        }                                                                                          \
+        size_t slot = Name##_find(self, key, hash_fn(key));                                        \
+        return slot == SIZE_MAX ? NULL : &self->entries[slot].value;                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool Name##_put(Name* self, K key, V value) {                                    \
+        if (!self) {                                                                               \
+            return false;                                                                          \
+        }                                                                                          \
+        uint64_t hash = hash_fn(key);                                                              \
+        size_t slot = Name##_find(self, key, hash);                                                \
+        if (slot != SIZE_MAX) {                                                                    \
+            self->entries[slot].value = value;                                                     \
+            return true;                                                                           \
+        }                                                                                          \
+        slot = arena_map_find_free(self->ctrl, self->capacity, hash);                              \
+        if (self->growth_left == 0 && self->ctrl[slot] == ARENA_MAP_EMPTY) {                       \
+            size_t capacity = self->capacity;                                                      \
+            if (self->count + 1 > capacity / 2) {                                                  \
+                capacity *= 2;                                                                     \
+            }                                                                                      \
+            if (!Name##_rehash(self, capacity)) {                                                  \
+                return false;                                                                      \
+            }                                                                                      \
+            slot = arena_map_find_free(self->ctrl, self->capacity, hash);                          \
+        }                                                                                          \
+        if (self->ctrl[slot] == ARENA_MAP_EMPTY) {                                                 \
+            self->growth_left--;                                                                   \
+        }                                                                                          \
+        self->ctrl[slot] = (uint8_t)(hash & 0x7F);                                                 \
+        self->entries[slot].key = key;                                                             \
+        self->entries[slot].value = value;                                                         \
+        self->count++;                                                                             \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool Name##_remove(Name* self, K key) {                                          \
+        if (!self || self->count == 0) {                                                           \
+            return false;                                                                          \
+        }                                                                                          \
+        size_t slot = Name##_find(self, key, hash_fn(key));                                        \
+        if (slot == SIZE_MAX) {                                                                    \
+            return false;                                                                          \
+        }                                                                                          \
+        arena_map_erase_slot(self->ctrl, slot, &self->growth_left);                                \
+        self->count--;                                                                             \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool Name##_reserve(Name* self, size_t count) {                                  \
+        if (!self) {                                                                               \
+            return false;                                                                          \
+        }                                                                                          \
+        size_t capacity = arena_map_capacity_for(count);                                           \
+        if (capacity <= self->capacity) {                                                          \
+            return true;                                                                           \
+        }                                                                                          \
+        return Name##_rehash(self, capacity);                                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline void Name##_clear(Name* self) {                                                  \
+        if (!self) {                                                                               \
+            return;                                                                                \
+        }                                                                                          \
+        memset(self->ctrl, ARENA_MAP_EMPTY, self->capacity);                                       \
+        self->count = 0;                                                                           \
+        self->growth_left = self->capacity - self->capacity / 8;                                   \
+    }                                                                                              \
+                                                                                                   \
+    static inline Name##_entry* Name##_next(Name* self, size_t* cursor) {                          \
+        if (!self || !cursor) {                                                                    \
+            return NULL;                                                                           \
+        }                                                                                          \
+        while (*cursor < self->capacity) {                                                         \
+            size_t slot = (*cursor)++;                                                             \
+            if (!(self->ctrl[slot] & 0x80)) {                                                      \
+                return &self->entries[slot];                                                       \
+            }                                                                                      \
+        }                                                                                          \
+        return NULL;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline Name* Name##_create(Arena* arena, size_t capacity) {                             \
+        if (!arena) {                                                                              \
+            return NULL;                                                                           \
+        }                                                                                          \
+        Name* self = (Name*)arena->alloc_aligned(arena->self, sizeof(Name), sizeof(void*));        \
+        if (!self) {                                                                               \
+            return NULL;                                                                           \
+        }                                                                                          \
+        self->self = self;                                                                         \
+        self->arena = arena;                                                                       \
+        self->ctrl = NULL;                                                                         \
+        self->entries = NULL;                                                                      \
+        self->capacity = 0;                                                                        \
+        self->count = 0;                                                                           \
+        self->growth_left = 0;                                                                     \
+        self->rewind_on_rehash = false;                                                            \
+        self->get = Name##_get;                                                                    \
+        self->put = Name##_put;                                                                    \
+        self->remove = Name##_remove;                                                              \
+        self->reserve = Name##_reserve;                                                            \
+        self->clear = Name##_clear;                                                                \
+        self->next = Name##_next;                                                                  \
+        if (!Name##_rehash(self, arena_map_capacity_for(capacity))) {                              \
+            return NULL;                                                                           \
+        }                                                                                          \
+        return self;                                                                               \
     }
 
-    new_chunk->head = self->head;
-    new_chunk->next = NULL;
+#define ARENA_MAP_HASH_INT(key) arena_hash_u64((uint64_t)(key))
+#define ARENA_MAP_EQ_INT(a, b) ((a) == (b))
 
-    Arena* current = self;
-    while (current->next != NULL) {
-        current = current->next;
-    }
-    current->next = new_chunk;
+#define ARENA_SEGLIST_MAX_SEGMENTS 48
 
-    return new_chunk->alloc(new_chunk, size);
-}
+typedef struct ArenaSegList ArenaSegList;
 
-static void* arena_alloc_aligned(Arena* self, size_t size, size_t alignment) {
-    if (!self || size == 0) {
-        return NULL;
-    }
+struct ArenaSegList {
+    ArenaSegList* self;
+    Arena* arena;
+    size_t element_size;
+    size_t stride;
+    size_t alignment;
+    size_t first_shift;
+    size_t count;
+    size_t segment_count;
+    void* segments[ARENA_SEGLIST_MAX_SEGMENTS];
 
-    if (!is_power_of_two(alignment)) {
-        fprintf(stderr, "Arena: Alignment must be a power of 2\n");
-        return NULL;
-    }
+    void* (*push)(ArenaSegList* self, const void* element);
+    void* (*at)(ArenaSegList* self, size_t index);
+    void* (*segment)(ArenaSegList* self, size_t index, size_t* length);
+    void (*clear)(ArenaSegList* self);
+};
 
-    size_t current_ptr = (size_t)self->memory + self->offset;
-    size_t aligned_ptr = align_forward(current_ptr, alignment);
-    size_t padding = aligned_ptr - current_ptr;
+ArenaSegList* ArenaSegList_create(Arena* arena, size_t element_size, size_t alignment, size_t first_segment);
 
-    if (self->offset + padding + size <= self->size) {
-        self->offset += padding;
-        void* ptr = (uint8_t*)self->memory + self->offset;
-        self->offset += size;
-        self->allocation_count++;
-        self->total_allocated += size + padding;
+#define ARENA_SEGLIST_AT(list, type, index) ((type*)(list)->at((list)->self, (index)))
 
-        if (self->offset > self->peak_usage) {
-            self->peak_usage = self->offset;
-        }
+typedef struct ArenaPool ArenaPool;
+typedef struct ArenaPoolCache ArenaPoolCache;
 
-        return ptr;
-    }
+struct ArenaPoolCache {
+    ArenaPool* pool;
+    void* free_list;
+    size_t count;
+    size_t capacity;
+};
 
-    size_t new_arena_size = self->size * 2;
-    size_t required_size = size + alignment;
-    if (new_arena_size < required_size) {
-        new_arena_size = required_size * 2;
-    }
+struct ArenaPool {
+    ArenaPool* self;
+    Arena* arena;
+    size_t object_size;
+    size_t batch_count;
+    void* free_list;
+    uint8_t* batch;
+    size_t batch_remaining;
+    size_t batches;
+    size_t slot_count;
+    size_t free_count;
+    bool locked;
+    volatile int lock;
+    void* volatile remote_free_list;
+    size_t remote_drained;
 
-    Arena* new_chunk = Arena_create(new_arena_size);
-    if (!new_chunk) {
-        fprintf(stderr, "Arena: Failed to grow arena\n");
-        return NULL;
-    }
+    void* (*alloc)(ArenaPool* self);
+    void (*free)(ArenaPool* self, void* ptr);
+    void (*remote_free)(ArenaPool* self, void* ptr);
+    void (*cache_init)(ArenaPool* self, ArenaPoolCache* cache, size_t capacity);
+    void* (*cache_alloc)(ArenaPool* self, ArenaPoolCache* cache);
+    void (*cache_free)(ArenaPool* self, ArenaPoolCache* cache, void* ptr);
+    void (*cache_flush)(ArenaPool* self, ArenaPoolCache* cache);
+    void (*print_stats)(ArenaPool* self);
+};
 
-    new_chunk->head = self->head;
-    new_chunk->next = NULL;
+ArenaPool* ArenaPool_create(Arena* arena, size_t object_size, size_t batch_count);
 
-    Arena* current = self;
-    while (current->next != NULL) {
-        current = current->next;
-    }
-    current->next = new_chunk;
+#define ARENA_SLAB_CLASS_COUNT 24
+#define ARENA_SLAB_MAX_SIZE 2048
+
+typedef struct ArenaSlab ArenaSlab;
+
+struct ArenaSlab {
+    ArenaSlab* self;
+    Arena* arena;
+    size_t slab_size;
+    ArenaPool* classes[ARENA_SLAB_CLASS_COUNT];
+    size_t large_count;
+    size_t large_bytes;
+
+    void* (*alloc)(ArenaSlab* self, size_t size);
+    void (*free)(ArenaSlab* self, void* ptr, size_t size);
+    void (*remote_free)(ArenaSlab* self, void* ptr, size_t size);
+    void* (*realloc)(ArenaSlab* self, void* ptr, size_t old_size, size_t new_size);
+    void (*print_stats)(ArenaSlab* self);
+};
+
+ArenaSlab* ArenaSlab_create(Arena* arena, size_t slab_size);
+
+#define ARENA_TLSF_SL_LOG2 5
+#define ARENA_TLSF_SL_COUNT (1 << ARENA_TLSF_SL_LOG2)
+#define ARENA_TLSF_FL_COUNT 32
+
+typedef struct ArenaTlsf ArenaTlsf;
+typedef struct ArenaTlsfBlock ArenaTlsfBlock;
+
+struct ArenaTlsfBlock {
+    ArenaTlsfBlock* prev_phys;
+    size_t size;
+    ArenaTlsfBlock* next_free;
+    ArenaTlsfBlock* prev_free;
+};
+
+struct ArenaTlsf {
+    ArenaTlsf* self;
+    Arena* arena;
+    size_t pool_size;
+    size_t pool_count;
+    size_t used_bytes;
+    size_t peak_bytes;
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[ARENA_TLSF_FL_COUNT];
+    ArenaTlsfBlock* blocks[ARENA_TLSF_FL_COUNT][ARENA_TLSF_SL_COUNT];
 
-    return new_chunk->alloc_aligned(new_chunk, size, alignment);
+    void* (*alloc)(ArenaTlsf* self, size_t size);
+    void (*free)(ArenaTlsf* self, void* ptr);
+    void* (*realloc)(ArenaTlsf* self, void* ptr, size_t new_size);
+    void (*print_stats)(ArenaTlsf* self);
+};
+
+ArenaTlsf* ArenaTlsf_create(Arena* arena, size_t pool_size);
+
+#define ARENA_BUDDY_MAX_ORDERS 32
+
+typedef struct ArenaBuddy ArenaBuddy;
+typedef struct ArenaBuddyNode ArenaBuddyNode;
+
+struct ArenaBuddyNode {
+    ArenaBuddyNode* next;
+    ArenaBuddyNode* prev;
+};
+
+struct ArenaBuddy {
+    ArenaBuddy* self;
+    Arena* arena;
+    uint8_t* memory;
+    size_t min_block;
+    size_t max_block;
+    size_t min_shift;
+    size_t max_order;
+    uint32_t nonempty;
+    ArenaBuddyNode* free_lists[ARENA_BUDDY_MAX_ORDERS];
+    size_t level_offset[ARENA_BUDDY_MAX_ORDERS];
+    uint64_t* free_bits;
+    uint8_t* orders;
+    size_t used_bytes;
+
+    void* (*alloc)(ArenaBuddy* self, size_t size);
+    void (*free)(ArenaBuddy* self, void* ptr);
+    void (*print_stats)(ArenaBuddy* self);
+};
+
+ArenaBuddy* ArenaBuddy_create(Arena* arena, size_t min_block, size_t max_block);
+
+#define ARENA_FRAME_RING_MAX 8
+
+typedef struct ArenaFrameRing ArenaFrameRing;
+typedef bool (*ArenaFrameFence)(void* user, uint64_t frame);
+
+struct ArenaFrameRing {
+    ArenaFrameRing* self;
+    Arena* arenas[ARENA_FRAME_RING_MAX];
+    uint64_t frames[ARENA_FRAME_RING_MAX];
+    volatile uint64_t retired[ARENA_FRAME_RING_MAX];
+    ArenaFrameFence fences[ARENA_FRAME_RING_MAX];
+    void* fence_users[ARENA_FRAME_RING_MAX];
+    size_t count;
+    uint64_t frame;
+    size_t waits;
+
+    Arena* (*begin_frame)(ArenaFrameRing* self);
+    void (*set_fence)(ArenaFrameRing* self, ArenaFrameFence fence, void* user);
+    void (*retire)(ArenaFrameRing* self, uint64_t frame);
+    bool (*is_retired)(ArenaFrameRing* self, uint64_t frame);
+    void (*destroy)(ArenaFrameRing* self);
+};
+
+ArenaFrameRing* ArenaFrameRing_create(size_t frame_count, size_t arena_size);
+
+typedef struct ArenaShared ArenaShared;
+typedef uint64_t ArenaSharedOffset;
+
+struct ArenaShared {
+    ArenaShared* self;
+    void* header;
+    uint8_t* data;
+    size_t size;
+    size_t mapped;
+    int fd;
+
+    void* (*alloc)(ArenaShared* self, size_t size);
+    void* (*alloc_aligned)(ArenaShared* self, size_t size, size_t alignment);
+    ArenaSharedOffset (*to_offset)(ArenaShared* self, const void* ptr);
+    void* (*from_offset)(ArenaShared* self, ArenaSharedOffset offset);
+    uint64_t (*generation)(ArenaShared* self);
+    void (*reset)(ArenaShared* self);
+    void (*print_stats)(ArenaShared* self);
+    void (*destroy)(ArenaShared* self);
+};
+
+ArenaShared* ArenaShared_create(const char* name, size_t size);
+ArenaShared* ArenaShared_open(const char* name);
+ArenaShared* ArenaShared_open_fd(int fd);
+bool ArenaShared_unlink(const char* name);
+
+typedef enum ArenaCheckpointMode {
+    ARENA_CHECKPOINT_AUTO,
+    ARENA_CHECKPOINT_FULL,
+    ARENA_CHECKPOINT_SOFT_DIRTY,
+    ARENA_CHECKPOINT_MPROTECT
+} ArenaCheckpointMode;
+
+typedef struct ArenaCheckpoint ArenaCheckpoint;
+
+struct ArenaCheckpoint {
+    ArenaCheckpoint* self;
+    Arena* arena;
+    ArenaCheckpointMode mode;
+    int fd;
+    void* regions;
+    size_t region_count;
+    size_t region_capacity;
+    void* faults;
+    uint64_t file_end;
+    uint64_t table_offset[2];
+    uint64_t table_space[2];
+    uint64_t generation;
+    size_t pages_written;
+    size_t pages_used;
+    ArenaCheckpoint* next_tracked;
+
+    bool (*save)(ArenaCheckpoint* self);
+    void (*print_stats)(ArenaCheckpoint* self);
+    void (*destroy)(ArenaCheckpoint* self);
+};
+
+ArenaCheckpoint* ArenaCheckpoint_create(Arena* arena, const char* path, ArenaCheckpointMode mode);
+Arena* Arena_create_from_checkpoint(const char* path);
+
+typedef intptr_t ArenaRelPtr;
+
+#define ARENA_REL_PTR(T) ArenaRelPtr
+#define ARENA_REL_GET(T, field) ((T*)arena_rel_get(&(field)))
+#define ARENA_REL_SET(field, target) arena_rel_set(&(field), (target))
+
+static inline void arena_rel_set(ArenaRelPtr* rel, const void* target) {
+    *rel = target ? (ArenaRelPtr)((uintptr_t)target - (uintptr_t)rel) : 0;
 }
 
-static void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size) {
-    if (!self) {
-        return NULL;
-    }
+static inline void* arena_rel_get(const ArenaRelPtr* rel) {
+    return *rel ? (void*)((uintptr_t)rel + (uintptr_t)*rel) : NULL;
+}
 
-    if (ptr == NULL) {
-        return arena_alloc(self, new_size);
-    }
+typedef uint32_t ArenaHandle;
 
-    if (new_size == 0) {
-        return NULL;
-    }
+#define ARENA_HANDLE_NULL 0u
+#define ARENA_HANDLE_DECODE(T, arena, handle, shift) ((T*)arena_handle_decode((arena), (handle), (shift)))
 
-    void* expected_ptr = (uint8_t*)self->memory + (self->offset - old_size);
-    if (ptr == expected_ptr) {
-        if (self->offset - old_size + new_size <= self->size) {
-            self->offset = self->offset - old_size + new_size;
-            if (self->offset > self->peak_usage) {
-                self->peak_usage = self->offset;
-            }
-            return ptr;
-        }
+static inline ArenaHandle arena_handle_encode(const Arena* arena, const void* ptr, unsigned shift) {
+    const Arena* head = arena->head;
+    uintptr_t offset = (uintptr_t)ptr - (uintptr_t)head->memory;
+    if (!ptr || offset >= head->size || (offset & (((uintptr_t)1 << shift) - 1)) != 0 ||
+        (offset >> shift) >= UINT32_MAX) {
+        return ARENA_HANDLE_NULL;
     }
+    return (ArenaHandle)(offset >> shift) + 1;
+}
 
-    void* new_ptr = arena_alloc(self, new_size);
-    if (new_ptr) {
-        size_t copy_size = old_size < new_size ? old_size : new_size;
-        memcpy(new_ptr, ptr, copy_size);
-    }
+static inline void* arena_handle_decode(const Arena* arena, ArenaHandle handle, unsigned shift) {
+    return handle ? (void*)((uint8_t*)arena->head->memory + ((uintptr_t)(handle - 1) << shift)) : NULL;
+}
 
-    return new_ptr;
+#ifdef __cplusplus
 }
+#endif
 
-static void arena_reset(Arena* self) {
-    if (!self) {
-        return;
+#ifdef __cplusplus
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K> >
+class ArenaHashMap {
+    static_assert(std::is_trivially_destructible<K>::value && std::is_trivially_destructible<V>::value,
+                  "ArenaHashMap entries are dropped without destructors when the arena resets");
+
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    class iterator {
+    public:
+        iterator(const ArenaHashMap* map, size_t slot) : map_(map), slot_(slot) { skip(); }
+        Entry& operator*() const { return map_->entries_[slot_]; }
+        Entry* operator->() const { return &map_->entries_[slot_]; }
+        iterator& operator++() {
+            slot_++;
+            skip();
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return slot_ == other.slot_; }
+        bool operator!=(const iterator& other) const { return slot_ != other.slot_; }
+
+    private:
+        void skip() {
+            while (slot_ < map_->capacity_ && (map_->ctrl_[slot_] & 0x80)) {
+                slot_++;
+            }
+        }
+        const ArenaHashMap* map_;
+        size_t slot_;
+    };
+
+    explicit ArenaHashMap(Arena* arena, size_t capacity = 0, bool rewind_on_rehash = false)
+        : arena_(arena), ctrl_(NULL), entries_(NULL), capacity_(0), count_(0), growth_left_(0),
+          rewind_on_rehash_(rewind_on_rehash) {
+        rehash(arena_map_capacity_for(capacity));
     }
 
-    Arena* head = self->head;
-    Arena* current = head;
-    while (current != NULL) {
-        current->offset = 0;
-        current->allocation_count = 0;
-        current = current->next;
+    ArenaHashMap(ArenaHashMap&& other)
+        : arena_(other.arena_), ctrl_(other.ctrl_), entries_(other.entries_), capacity_(other.capacity_),
+          count_(other.count_), growth_left_(other.growth_left_), rewind_on_rehash_(other.rewind_on_rehash_) {
+        other.ctrl_ = NULL;
+        other.entries_ = NULL;
+        other.capacity_ = 0;
+        other.count_ = 0;
+        other.growth_left_ = 0;
     }
-}
 
-static void arena_reset_to_mark(Arena* self, size_t mark) {
-    if (!self) {
-        return;
+    ArenaHashMap(const ArenaHashMap&) = delete;
+    ArenaHashMap& operator=(const ArenaHashMap&) = delete;
+
+    V* find(const K& key) {
+        size_t slot = find_slot(key, hash_of(key));
+        return slot == SIZE_MAX ? NULL : &entries_[slot].value;
     }
 
-    Arena* head = self->head;
-    Arena* current = head;
-    size_t cumulative_size = 0;
-    bool found = false;
+    const V* find(const K& key) const { return const_cast<ArenaHashMap*>(this)->find(key); }
 
-    while (current != NULL) {
-        size_t next_cumulative = cumulative_size + current->size;
+    bool contains(const K& key) const { return find(key) != NULL; }
 
-        if (!found && mark <= next_cumulative) {
-            current->offset = mark - cumulative_size;
-            found = true;
-        } else if (found) {
-            current->offset = 0;
-            current->allocation_count = 0;
+    V* insert(const K& key, const V& value) {
+        uint64_t hash = hash_of(key);
+        size_t slot = find_slot(key, hash);
+        if (slot != SIZE_MAX) {
+            entries_[slot].value = value;
+            return &entries_[slot].value;
         }
-
-        cumulative_size = next_cumulative;
-        current = current->next;
+        if (!ctrl_) {
+            return NULL;
+        }
+        slot = arena_map_find_free(ctrl_, capacity_, hash);
+        if (growth_left_ == 0 && ctrl_[slot] == ARENA_MAP_EMPTY) {
+            if (!rehash(count_ + 1 > capacity_ / 2 ? capacity_ * 2 : capacity_)) {
+                return NULL;
+            }
+            slot = arena_map_find_free(ctrl_, capacity_, hash);
+        }
+        if (ctrl_[slot] == ARENA_MAP_EMPTY) {
+            growth_left_--;
+        }
+        ctrl_[slot] = (uint8_t)(hash & 0x7F);
+        new (&entries_[slot]) Entry{key, value};
+        count_++;
+        return &entries_[slot].value;
     }
-}
 
-static size_t arena_get_mark(Arena* self) {
-    if (!self) {
-        return 0;
+    bool erase(const K& key) {
+        size_t slot = find_slot(key, hash_of(key));
+        if (slot == SIZE_MAX) {
+            return false;
+        }
+        arena_map_erase_slot(ctrl_, slot, &growth_left_);
+        count_--;
+        return true;
     }
 
-    Arena* head = self->head;
-    Arena* current = head;
-    size_t cumulative_offset = 0;
+    bool reserve(size_t count) {
+        size_t capacity = arena_map_capacity_for(count);
+        return capacity <= capacity_ || rehash(capacity);
+    }
 
-    while (current != NULL) {
-        if (current == self) {
-            return cumulative_offset + current->offset;
+    void clear() {
+        if (ctrl_) {
+            memset(ctrl_, ARENA_MAP_EMPTY, capacity_);
         }
-        cumulative_offset += current->offset;
-        current = current->next;
+        count_ = 0;
+        growth_left_ = capacity_ - capacity_ / 8;
     }
 
-    return cumulative_offset;
-}
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return count_ == 0; }
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, capacity_); }
 
-static bool arena_resize(Arena* self, size_t new_size) {
-    if (!self || new_size == 0) {
-        return false;
-    }
+private:
+    static uint64_t hash_of(const K& key) { return arena_hash_u64((uint64_t)Hash()(key)); }
 
-    if (new_size < self->offset) {
-        fprintf(stderr, "Arena: Cannot resize to smaller than current usage\n");
-        return false;
+    size_t find_slot(const K& key, uint64_t hash) const {
+        if (count_ == 0) {
+            return SIZE_MAX;
+        }
+        size_t group_mask = capacity_ / ARENA_MAP_GROUP_WIDTH - 1;
+        size_t group = (size_t)(hash >> 7) & group_mask;
+        uint8_t h2 = (uint8_t)(hash & 0x7F);
+        for (size_t step = 1; step <= group_mask + 1; step++) {
+            const uint8_t* ctrl = ctrl_ + group * ARENA_MAP_GROUP_WIDTH;
+            uint32_t candidates = arena_map_match(ctrl, h2);
+            while (candidates) {
+                size_t slot = group * ARENA_MAP_GROUP_WIDTH + arena_ctz32(candidates);
+                if (Eq()(entries_[slot].key, key)) {
+                    return slot;
+                }
+                candidates &= candidates - 1;
+            }
+            if (arena_map_match_empty(ctrl)) {
+                break;
+            }
+            group = (group + step) & group_mask;
+        }
+        return SIZE_MAX;
     }
 
-    void* new_memory = realloc(self->memory, new_size);
-    if (!new_memory) {
-        fprintf(stderr, "Arena: Failed to resize arena\n");
-        return false;
+    bool rehash(size_t capacity) {
+        size_t bytes = arena_map_table_bytes(capacity, sizeof(Entry));
+        uint8_t* table = (uint8_t*)arena_->alloc_aligned(arena_->self, bytes, ARENA_MAP_GROUP_WIDTH);
+        if (!table) {
+            return false;
+        }
+        memset(table, ARENA_MAP_EMPTY, capacity);
+        Entry* entries = (Entry*)(table + capacity);
+        for (size_t i = 0; i < capacity_; i++) {
+            if (ctrl_[i] & 0x80) {
+                continue;
+            }
+            uint64_t hash = hash_of(entries_[i].key);
+            size_t slot = arena_map_find_free(table, capacity, hash);
+            table[slot] = (uint8_t)(hash & 0x7F);
+            new (&entries[slot]) Entry(std::move(entries_[i]));
+        }
+        if (rewind_on_rehash_ && ctrl_ && std::is_trivially_copyable<Entry>::value) {
+            size_t old_bytes = arena_map_table_bytes(capacity_, sizeof(Entry));
+            table = (uint8_t*)arena_map_release_table(arena_, ctrl_, old_bytes, table, bytes);
+            entries = (Entry*)(table + capacity);
+        }
+        ctrl_ = table;
+        entries_ = entries;
+        capacity_ = capacity;
+        growth_left_ = capacity - capacity / 8 - count_;
+        return true;
     }
 
-    self->memory = new_memory;
-    self->size = new_size;
+    Arena* arena_;
+    uint8_t* ctrl_;
+    Entry* entries_;
+    size_t capacity_;
+    size_t count_;
+    size_t growth_left_;
+    bool rewind_on_rehash_;
+};
 
-    return true;
-}
+template <typename T>
+class arena_rel_ptr {
+public:
+    arena_rel_ptr() : offset_(0) {}
+    arena_rel_ptr(T* target) { arena_rel_set(&offset_, target); }
+    arena_rel_ptr(const arena_rel_ptr& other) { arena_rel_set(&offset_, other.get()); }
 
-static void arena_print_stats(Arena* self) {
-    if (!self) {
-        return;
+    arena_rel_ptr& operator=(const arena_rel_ptr& other) {
+        arena_rel_set(&offset_, other.get());
+        return *this;
     }
 
-    Arena* head = self->head;
+    arena_rel_ptr& operator=(T* target) {
+        arena_rel_set(&offset_, target);
+        return *this;
+    }
 
-    printf("\n=== Arena Statistics ===\n");
+    T* get() const { return static_cast<T*>(arena_rel_get(&offset_)); }
+    T& operator*() const { return *get(); }
+    T* operator->() const { return get(); }
+    T& operator[](size_t index) const { return get()[index]; }
+    explicit operator bool() const { return offset_ != 0; }
+    bool operator==(const arena_rel_ptr& other) const { return get() == other.get(); }
+    bool operator!=(const arena_rel_ptr& other) const { return get() != other.get(); }
 
-    size_t total_size = 0;
-    size_t total_used = 0;
-    size_t total_allocations = 0;
-    size_t chunk_count = 0;
+private:
+    ArenaRelPtr offset_;
+};
+#endif
 
-    Arena* current = head;
-    while (current != NULL) {
-        chunk_count++;
-        total_size += current->size;
-        total_used += current->offset;
+#ifdef ARENA_IMPLEMENTATION
+
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ARENA_HAS_MMAP 1
+#endif
+
+static void* arena_alloc(Arena* self, size_t size);
+static void* arena_alloc_aligned(Arena* self, size_t size, size_t alignment);
+static void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size);
+static bool arena_free_last(Arena* self, void* ptr, size_t size);
+static void* arena_alloc_down(Arena* self, size_t size);
+static void* arena_alloc_aligned_down(Arena* self, size_t size, size_t alignment);
+static void* arena_realloc_down(Arena* self, void* ptr, size_t old_size, size_t new_size);
+static void arena_reset(Arena* self);
+static void arena_reset_to_mark(Arena* self, size_t mark);
+static size_t arena_get_mark(Arena* self);
+static void* arena_alloc_high(Arena* self, size_t size);
+static void* arena_alloc_high_aligned(Arena* self, size_t size, size_t alignment);
+static void arena_reset_high(Arena* self);
+static void arena_reset_high_to_mark(Arena* self, size_t mark);
+static size_t arena_get_high_mark(Arena* self);
+static void arena_destroy(Arena* self);
+static void arena_snapshot_prune(Arena* head);
+static void arena_print_stats(Arena* self);
+static ArenaResizeResult arena_resize(Arena* self, size_t new_size);
+
+static inline size_t align_forward(size_t ptr, size_t alignment) {
+    size_t modulo = ptr & (alignment - 1);
+    if (modulo != 0) {
+        ptr += alignment - modulo;
+    }
+    return ptr;
+}
+
+static inline bool is_power_of_two(size_t x) {
+    return (x != 0) && ((x & (x - 1)) == 0);
+}
+
+typedef struct ArenaHole {
+    struct ArenaHole* next;
+    size_t size;
+} ArenaHole;
+
+static inline size_t arena_hole_bin(size_t size) {
+    size_t bin = (63 - arena_clz64(size)) - 4;
+    return bin < ARENA_HOLE_BINS ? bin : ARENA_HOLE_BINS - 1;
+}
+
+static void arena_hole_push(Arena* head, void* ptr, size_t size) {
+    size_t padding = align_forward((size_t)ptr, sizeof(void*)) - (size_t)ptr;
+    if (size < ARENA_HOLE_MIN_SIZE + padding) {
+        return;
+    }
+    ptr = (uint8_t*)ptr + padding;
+    size -= padding;
+
+    size_t bin = arena_hole_bin(size);
+    ArenaHole* hole = (ArenaHole*)ptr;
+    hole->next = (ArenaHole*)head->holes[bin];
+    hole->size = size;
+    head->holes[bin] = hole;
+    head->hole_mask |= 1u << bin;
+    head->hole_bytes += size;
+}
+
+static void* arena_hole_take(Arena* head, size_t size) {
+    size_t bin = size < ARENA_HOLE_MIN_SIZE ? 0 : arena_hole_bin(size);
+    ArenaHole* hole = (ArenaHole*)head->holes[bin];
+
+    if (!hole || hole->size < size) {
+        uint32_t larger = bin + 1 < ARENA_HOLE_BINS ? head->hole_mask & (~0u << (bin + 1)) : 0;
+        if (!larger) {
+            return NULL;
+        }
+        bin = arena_ctz32(larger);
+        hole = (ArenaHole*)head->holes[bin];
+    }
+
+    head->holes[bin] = hole->next;
+    if (!hole->next) {
+        head->hole_mask &= ~(1u << bin);
+    }
+
+    size_t hole_size = hole->size;
+    head->hole_bytes -= hole_size;
+    head->reclaimed_bytes += size;
+    arena_hole_push(head, (uint8_t*)hole + size, hole_size - size);
+
+    return hole;
+}
+
+static void arena_hole_clear(Arena* head) {
+    head->hole_mask = 0;
+    memset(head->holes, 0, sizeof(head->holes));
+    head->hole_bytes = 0;
+}
+
+typedef struct ArenaHuge {
+    struct ArenaHuge* next;
+    size_t length;
+    size_t header;
+    size_t base;
+    Arena* owner;
+    size_t owner_base;
+    uint64_t serial;
+} ArenaHuge;
+
+static size_t arena_page_size(void) {
+#ifdef ARENA_HAS_MMAP
+    return (size_t)sysconf(_SC_PAGESIZE);
+#else
+    return 4096;
+#endif
+}
+
+static void* arena_os_map(size_t length) {
+#ifdef ARENA_HAS_MMAP
+    void* memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+#else
+    return malloc(length);
+#endif
+}
+
+static void arena_os_unmap(void* memory, size_t length) {
+#ifdef ARENA_HAS_MMAP
+    munmap(memory, length);
+#else
+    (void)length;
+    free(memory);
+#endif
+}
+
+static void* arena_os_remap(void* memory, size_t old_length, size_t new_length) {
+#if defined(ARENA_HAS_MMAP) && defined(MREMAP_MAYMOVE)
+    void* moved = mremap(memory, old_length, new_length, MREMAP_MAYMOVE);
+    return moved == MAP_FAILED ? NULL : moved;
+#elif defined(ARENA_HAS_MMAP)
+    void* moved = arena_os_map(new_length);
+    if (moved) {
+        memcpy(moved, memory, old_length < new_length ? old_length : new_length);
+        munmap(memory, old_length);
+    }
+    return moved;
+#else
+    (void)old_length;
+    return realloc(memory, new_length);
+#endif
+}
+
+static size_t arena_split_active(Arena* head, size_t length);
+
+static uint64_t arena_serial = 0;
+
+static uint64_t arena_next_serial(void) {
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedIncrement64((volatile long long*)&arena_serial);
+#else
+    return __atomic_add_fetch(&arena_serial, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static void* arena_huge_alloc(Arena* head, size_t size, size_t alignment) {
+    size_t header = align_forward(sizeof(ArenaHuge), alignment < 16 ? 16 : alignment);
+    size_t length = align_forward(header + size, arena_page_size());
+    if (length < size) {
+        fprintf(stderr, "Arena: Allocation size overflow\n");
+        return NULL;
+    }
+
+    ArenaHuge* huge = (ArenaHuge*)arena_os_map(length);
+    if (!huge) {
+        fprintf(stderr, "Arena: Failed to map %zu bytes\n", length);
+        return NULL;
+    }
+
+    huge->length = length;
+    huge->header = header;
+    huge->serial = arena_next_serial();
+    huge->owner = head->active;
+    huge->owner_base = head->active->base;
+    huge->base = arena_split_active(head, length);
+    huge->next = (ArenaHuge*)head->huge;
+    head->huge = huge;
+    head->huge_count++;
+    head->huge_bytes += length;
+    head->allocation_count++;
+    head->total_allocated += size;
+
+    return (uint8_t*)huge + header;
+}
+
+static ArenaHuge** arena_huge_find(Arena* head, void* ptr) {
+    ArenaHuge** link = (ArenaHuge**)&head->huge;
+    while (*link) {
+        if ((uint8_t*)*link + (*link)->header == (uint8_t*)ptr) {
+            return link;
+        }
+        link = &(*link)->next;
+    }
+    return NULL;
+}
+
+static void* arena_huge_realloc(Arena* head, ArenaHuge** link, size_t new_size) {
+    ArenaHuge* huge = *link;
+    size_t length = align_forward(huge->header + new_size, arena_page_size());
+    if (length < new_size) {
+        fprintf(stderr, "Arena: Allocation size overflow\n");
+        return NULL;
+    }
+
+    if (length != huge->length) {
+        ArenaHuge* moved = (ArenaHuge*)arena_os_remap(huge, huge->length, length);
+        if (!moved) {
+            fprintf(stderr, "Arena: Failed to remap %zu bytes\n", length);
+            return NULL;
+        }
+#ifdef ARENA_HAS_MMAP
+        mprotect(moved, length, PROT_READ | PROT_WRITE);
+#endif
+        head->huge_bytes = head->huge_bytes - moved->length + length;
+        moved->length = length;
+        moved->serial = arena_next_serial();
+        *link = moved;
+        huge = moved;
+    }
+
+    return (uint8_t*)huge + huge->header;
+}
+
+static void arena_huge_release(Arena* head, size_t mark) {
+    ArenaHuge** link = (ArenaHuge**)&head->huge;
+    while (*link) {
+        ArenaHuge* huge = *link;
+        if (mark > huge->base) {
+            link = &huge->next;
+            continue;
+        }
+        if (huge->owner_base < huge->owner->base) {
+            huge->owner->base = huge->owner_base;
+        }
+        *link = huge->next;
+        head->huge_count--;
+        head->huge_bytes -= huge->length;
+        arena_os_unmap(huge, huge->length);
+    }
+}
+
+static Arena* arena_wrap_memory(void* memory, size_t size, ArenaMemoryKind memory_kind) {
+    Arena* self = (Arena*)malloc(sizeof(Arena));
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to allocate arena struct\n");
+        return NULL;
+    }
+
+    self->self = self;
+    self->memory = memory;
+    self->memory_kind = memory_kind;
+    self->serial = arena_next_serial();
+    memset(&self->backing, 0, sizeof(self->backing));
+    self->reserved = 0;
+    self->size = size;
+    self->offset = 0;
+    self->high_offset = 0;
+    self->peak_usage = 0;
+    self->next = NULL;
+    self->head = self;
+    self->high_chunk = self;
+    self->active = self;
+    memset(self->spares, 0, sizeof(self->spares));
+    self->spare_count = 0;
+    self->base = 0;
+    self->next_base = size;
+    self->owner = NULL;
+    self->owner_base = 0;
+    self->owner_mark = 0;
+    self->reuse_mark = 0;
+    self->reuse_base = 0;
+    self->reuse_offset = 0;
+    self->huge = NULL;
+    self->huge_count = 0;
+    self->huge_bytes = 0;
+    self->huge_threshold = ARENA_HUGE_THRESHOLD;
+    self->retain_target = ARENA_RETAIN_ALL;
+    self->retain_decay_resets = 0;
+    self->retain_decay_ms = 0.0;
+    self->retain_limit = SIZE_MAX;
+    self->retain_stamp = 0.0;
+    self->released_bytes = 0;
+    self->adaptive = false;
+    self->usage_average = 0;
+    self->profile = NULL;
+    self->snapshot_relocations = 0;
+    self->snapshot_slots = NULL;
+    self->snapshot_slot_count = 0;
+    self->snapshot_slot_capacity = 0;
+    self->snapshot_scan = false;
+    self->file_fd = -1;
+    self->file_header = NULL;
+    self->file_private = false;
+    self->forkable = false;
+    self->frozen = false;
+    self->allocation_count = 0;
+    self->total_allocated = 0;
+    self->hole_mask = 0;
+    memset(self->holes, 0, sizeof(self->holes));
+    self->hole_bytes = 0;
+    self->reclaimed_bytes = 0;
+    self->bump_down = false;
+    self->contiguous = false;
+    self->alloc = arena_alloc;
+    self->alloc_aligned = arena_alloc_aligned;
+    self->realloc = arena_realloc;
+    self->free_last = arena_free_last;
+    self->reset = arena_reset;
+    self->reset_to_mark = arena_reset_to_mark;
+    self->get_mark = arena_get_mark;
+    self->alloc_high = arena_alloc_high;
+    self->alloc_high_aligned = arena_alloc_high_aligned;
+    self->reset_high = arena_reset_high;
+    self->reset_high_to_mark = arena_reset_high_to_mark;
+    self->get_high_mark = arena_get_high_mark;
+    self->destroy = arena_destroy;
+    self->print_stats = arena_print_stats;
+    self->resize = arena_resize;
+
+    return self;
+}
+
+Arena* Arena_create(size_t size) {
+    if (size == 0) {
+        fprintf(stderr, "Arena: Cannot create arena with size 0\n");
+        return NULL;
+    }
+
+    void* memory = malloc(size);
+    if (!memory) {
+        fprintf(stderr, "Arena: Failed to allocate arena memory of size %zu\n", size);
+        return NULL;
+    }
+
+    Arena* self = arena_wrap_memory(memory, size, ARENA_MEMORY_HEAP);
+    if (!self) {
+        free(memory);
+    }
+
+    return self;
+}
+
+typedef struct ArenaFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t offset;
+    uint64_t root;
+} ArenaFileHeader;
+
+static size_t arena_chunk_span(const Arena* chunk) {
+    return chunk->reserved > chunk->size ? chunk->reserved : chunk->size;
+}
+
+static void arena_chunk_release(Arena* chunk) {
+    if (chunk->memory_kind == ARENA_MEMORY_MAPPED) {
+        arena_os_unmap(chunk->memory, arena_chunk_span(chunk));
+    } else if (chunk->memory_kind == ARENA_MEMORY_RESERVED) {
+        arena_os_unmap(chunk->memory, chunk->reserved);
+    } else if (chunk->memory_kind == ARENA_MEMORY_CUSTOM) {
+        chunk->backing.release(chunk->backing.ctx, chunk->memory, chunk->reserved);
+    } else if (chunk->memory_kind == ARENA_MEMORY_FILE) {
+        ((ArenaFileHeader*)chunk->file_header)->offset = chunk->offset;
+        arena_os_unmap(chunk->file_header, chunk->reserved);
+#ifdef ARENA_HAS_MMAP
+        close(chunk->file_fd);
+#endif
+    } else {
+        free(chunk->memory);
+    }
+}
+
+static void* arena_backing_acquire(const ArenaBacking* backing, size_t size, size_t reserve) {
+    void* memory = backing->reserve(backing->ctx, reserve);
+    if (memory && backing->commit && !backing->commit(backing->ctx, memory, size)) {
+        backing->release(backing->ctx, memory, reserve);
+        return NULL;
+    }
+    return memory;
+}
+
+static ArenaResizeResult arena_file_extend(Arena* chunk, size_t new_size) {
+#ifdef ARENA_HAS_MMAP
+    ArenaFileHeader* header = (ArenaFileHeader*)chunk->file_header;
+    size_t target = align_forward(new_size, arena_page_size());
+    if (target < new_size) {
+        return ARENA_RESIZE_FAILED;
+    }
+    if (target <= header->capacity) {
+        return ARENA_RESIZE_IN_PLACE;
+    }
+    if (header->header_size + target > chunk->reserved) {
+        fprintf(stderr, "Arena: File-backed arena reached its maximum size of %zu bytes\n",
+                chunk->reserved - header->header_size);
+        return ARENA_RESIZE_FAILED;
+    }
+
+    struct stat info;
+    if (fstat(chunk->file_fd, &info) != 0 ||
+        ((uint64_t)info.st_size < header->header_size + target &&
+         ftruncate(chunk->file_fd, (off_t)(header->header_size + target)) != 0)) {
+        fprintf(stderr, "Arena: Failed to extend arena file\n");
+        return ARENA_RESIZE_FAILED;
+    }
+    void* mapped = mmap((uint8_t*)chunk->memory + header->capacity, target - header->capacity,
+                        PROT_READ | PROT_WRITE, (chunk->file_private ? MAP_PRIVATE : MAP_SHARED) | MAP_FIXED,
+                        chunk->file_fd,
+                        (off_t)(header->header_size + header->capacity));
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Arena: Failed to map extended arena file\n");
+        return ARENA_RESIZE_FAILED;
+    }
+
+    header->capacity = target;
+    return ARENA_RESIZE_COMMITTED;
+#else
+    (void)chunk;
+    (void)new_size;
+    return ARENA_RESIZE_FAILED;
+#endif
+}
+
+static ArenaResizeResult arena_chunk_extend(Arena* chunk, size_t new_size) {
+    if (chunk->memory_kind == ARENA_MEMORY_HEAP || chunk->memory_kind == ARENA_MEMORY_MAPPED) {
+        return new_size <= chunk->reserved ? ARENA_RESIZE_IN_PLACE : ARENA_RESIZE_FAILED;
+    }
+
+    if (chunk->memory_kind == ARENA_MEMORY_CUSTOM) {
+        if (new_size > chunk->reserved) {
+            return ARENA_RESIZE_FAILED;
+        }
+        if (chunk->backing.commit && !chunk->backing.commit(chunk->backing.ctx, chunk->memory, new_size)) {
+            return ARENA_RESIZE_FAILED;
+        }
+        return ARENA_RESIZE_COMMITTED;
+    }
+
+#ifdef ARENA_HAS_MMAP
+    if (chunk->memory_kind == ARENA_MEMORY_FILE) {
+        return arena_file_extend(chunk, new_size);
+    }
+    if (chunk->memory_kind != ARENA_MEMORY_RESERVED) {
+        return ARENA_RESIZE_FAILED;
+    }
+
+    size_t page = arena_page_size();
+    size_t committed = align_forward(chunk->size, page);
+    size_t target = align_forward(new_size, page);
+    if (target < new_size) {
+        return ARENA_RESIZE_FAILED;
+    }
+    if (target <= committed) {
+        return ARENA_RESIZE_IN_PLACE;
+    }
+
+    if (target <= chunk->reserved) {
+        if (mprotect((uint8_t*)chunk->memory + committed, target - committed, PROT_READ | PROT_WRITE) != 0) {
+            return ARENA_RESIZE_FAILED;
+        }
+        return ARENA_RESIZE_COMMITTED;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    if (committed < chunk->reserved &&
+        mprotect((uint8_t*)chunk->memory + committed, chunk->reserved - committed, PROT_READ | PROT_WRITE) != 0) {
+        return ARENA_RESIZE_FAILED;
+    }
+    if (mremap(chunk->memory, chunk->reserved, target, 0) == MAP_FAILED) {
+        return ARENA_RESIZE_FAILED;
+    }
+    chunk->reserved = target;
+    return ARENA_RESIZE_IN_PLACE;
+#else
+    return ARENA_RESIZE_FAILED;
+#endif
+#else
+    (void)chunk;
+    (void)new_size;
+    return ARENA_RESIZE_FAILED;
+#endif
+}
+
+static ArenaResizeResult arena_chunk_grow(Arena* chunk, size_t new_size) {
+    Arena* head = chunk->head;
+    size_t span = arena_chunk_span(chunk);
+    bool last = chunk->base + span == head->next_base;
+    if (new_size > span && !last) {
+        return ARENA_RESIZE_FAILED;
+    }
+
+    ArenaResizeResult result = arena_chunk_extend(chunk, new_size);
+    if (result == ARENA_RESIZE_FAILED) {
+        return result;
+    }
+
+    size_t top = chunk->bump_down ? chunk->offset : chunk->high_offset;
+    if (top > 0) {
+        memmove((uint8_t*)chunk->memory + new_size - top, (uint8_t*)chunk->memory + chunk->size - top, top);
+    }
+    chunk->size = new_size;
+    if (last) {
+        head->next_base = chunk->base + arena_chunk_span(chunk);
+    }
+    return result;
+}
+
+static void arena_set_bump_down(Arena* self) {
+    self->bump_down = true;
+    self->alloc = arena_alloc_down;
+    self->alloc_aligned = arena_alloc_aligned_down;
+    self->realloc = arena_realloc_down;
+}
+
+Arena* Arena_create_bump_down(size_t size) {
+    Arena* self = Arena_create(size);
+    if (!self) {
+        return NULL;
+    }
+
+    arena_set_bump_down(self);
+
+    return self;
+}
+
+Arena* Arena_create_ex(size_t size, size_t reserve, const ArenaBacking* backing) {
+    if (!backing) {
+        return Arena_create(size);
+    }
+    if (size == 0) {
+        fprintf(stderr, "Arena: Cannot create arena with size 0\n");
+        return NULL;
+    }
+    if (!backing->reserve || !backing->release) {
+        fprintf(stderr, "Arena: Backing allocator needs reserve and release callbacks\n");
+        return NULL;
+    }
+
+    reserve = reserve > size ? reserve : size;
+    void* memory = arena_backing_acquire(backing, size, reserve);
+    if (!memory) {
+        fprintf(stderr, "Arena: Backing allocator failed to provide %zu bytes\n", reserve);
+        return NULL;
+    }
+
+    Arena* self = arena_wrap_memory(memory, size, ARENA_MEMORY_CUSTOM);
+    if (!self) {
+        backing->release(backing->ctx, memory, reserve);
+        return NULL;
+    }
+    self->backing = *backing;
+    self->reserved = reserve;
+    self->next_base = reserve;
+    self->huge_threshold = 0;
+
+    return self;
+}
+
+static Arena* arena_chunk_create(Arena* head, size_t size) {
+    Arena* chunk = head->memory_kind == ARENA_MEMORY_CUSTOM ? Arena_create_ex(size, 0, &head->backing)
+                                                             : Arena_create(size);
+    if (chunk && head->bump_down) {
+        arena_set_bump_down(chunk);
+    }
+    return chunk;
+}
+
+static void* arena_malloc_reserve(void* ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void arena_malloc_release(void* ctx, void* memory, size_t size) {
+    (void)ctx;
+    (void)size;
+    free(memory);
+}
+
+ArenaBacking arena_backing_malloc(void) {
+    ArenaBacking backing = {arena_malloc_reserve, NULL, arena_malloc_release, NULL};
+    return backing;
+}
+
+#ifdef ARENA_HAS_MMAP
+static void* arena_mmap_reserve(void* ctx, size_t size) {
+    (void)ctx;
+    void* memory = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+static bool arena_mmap_commit(void* ctx, void* memory, size_t size) {
+    (void)ctx;
+    return mprotect(memory, align_forward(size, arena_page_size()), PROT_READ | PROT_WRITE) == 0;
+}
+
+static void arena_mmap_release(void* ctx, void* memory, size_t size) {
+    (void)ctx;
+    munmap(memory, size);
+}
+#endif
+
+ArenaBacking arena_backing_mmap(void) {
+#ifdef ARENA_HAS_MMAP
+    ArenaBacking backing = {arena_mmap_reserve, arena_mmap_commit, arena_mmap_release, NULL};
+    return backing;
+#else
+    return arena_backing_malloc();
+#endif
+}
+
+static void* arena_static_reserve(void* ctx, size_t size) {
+    ArenaStaticBacking* state = (ArenaStaticBacking*)ctx;
+    uintptr_t base = (uintptr_t)state->memory;
+    size_t start = align_forward(base + state->used, 2 * sizeof(void*)) - base;
+    if (start > state->size || size > state->size - start) {
+        return NULL;
+    }
+    state->used = start + size;
+    state->live += size;
+    return state->memory + start;
+}
+
+static void arena_static_release(void* ctx, void* memory, size_t size) {
+    ArenaStaticBacking* state = (ArenaStaticBacking*)ctx;
+    state->live -= size;
+    if (state->live == 0) {
+        state->used = 0;
+    } else if ((uint8_t*)memory + size == state->memory + state->used) {
+        state->used = (size_t)((uint8_t*)memory - state->memory);
+    }
+}
+
+ArenaBacking arena_backing_static(ArenaStaticBacking* state, void* memory, size_t size) {
+    state->memory = (uint8_t*)memory;
+    state->size = size;
+    state->used = 0;
+    state->live = 0;
+    ArenaBacking backing = {arena_static_reserve, NULL, arena_static_release, state};
+    return backing;
+}
+
+Arena* Arena_create_contiguous(size_t size, size_t reserve) {
+    Arena* self = Arena_create_reserved(size, reserve);
+    if (!self) {
+        return NULL;
+    }
+
+    self->contiguous = true;
+
+    return self;
+}
+
+Arena* Arena_create_reserved(size_t size, size_t reserve) {
+#ifdef ARENA_HAS_MMAP
+    if (size == 0) {
+        fprintf(stderr, "Arena: Cannot create arena with size 0\n");
+        return NULL;
+    }
+
+    size_t page = arena_page_size();
+    size_t committed = align_forward(size, page);
+    reserve = align_forward(reserve > committed ? reserve : committed, page);
+    void* memory = mmap(NULL, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "Arena: Failed to reserve %zu bytes of address space\n", reserve);
+        return NULL;
+    }
+    if (mprotect(memory, committed, PROT_READ | PROT_WRITE) != 0) {
+        fprintf(stderr, "Arena: Failed to commit arena memory of size %zu\n", size);
+        munmap(memory, reserve);
+        return NULL;
+    }
+
+    Arena* self = arena_wrap_memory(memory, size, ARENA_MEMORY_RESERVED);
+    if (!self) {
+        munmap(memory, reserve);
+        return NULL;
+    }
+    self->reserved = reserve;
+    self->next_base = reserve;
+
+    return self;
+#else
+    (void)reserve;
+    return Arena_create(size);
+#endif
+}
+
+static size_t arena_adapt_estimate(size_t average) {
+    if (average == 0) {
+        return 0;
+    }
+    return align_forward(average + average / 4, ARENA_ADAPT_GRANULE);
+}
+
+Arena* Arena_create_adaptive(size_t size, ArenaSiteProfile* profile) {
+    if (profile && profile->usage_average > 0) {
+        size = arena_adapt_estimate(profile->usage_average);
+    }
+
+    Arena* self = Arena_create(size);
+    if (!self) {
+        return NULL;
+    }
+
+    self->adaptive = true;
+    self->profile = profile;
+    self->usage_average = profile ? profile->usage_average : 0;
+
+    return self;
+}
+
+static inline size_t arena_chunk_free(Arena* chunk) {
+    return chunk->size - chunk->offset - chunk->high_offset;
+}
+
+static void arena_spare_push(Arena* head, Arena* chunk) {
+    size_t free_bytes = arena_chunk_free(chunk);
+    if (free_bytes < ARENA_SPARE_MIN_FREE) {
+        return;
+    }
+
+    if (head->spare_count < ARENA_SPARE_CHUNKS) {
+        head->spares[head->spare_count++] = chunk;
+        return;
+    }
+
+    size_t smallest = 0;
+    for (size_t i = 1; i < ARENA_SPARE_CHUNKS; i++) {
+        if (arena_chunk_free(head->spares[i]) < arena_chunk_free(head->spares[smallest])) {
+            smallest = i;
+        }
+    }
+    if (arena_chunk_free(head->spares[smallest]) < free_bytes) {
+        head->spares[smallest] = chunk;
+    }
+}
+
+static size_t arena_split_active(Arena* head, size_t length) {
+    Arena* active = head->active;
+    size_t base = head->next_base;
+    head->next_base += length;
+    active->base = head->next_base - active->offset;
+    head->next_base += arena_chunk_span(active) - active->offset;
+    return base;
+}
+
+static void arena_spare_reuse(Arena* head, Arena* chunk) {
+    chunk->reuse_mark = head->next_base;
+    chunk->reuse_base = chunk->base;
+    chunk->reuse_offset = chunk->offset;
+    chunk->base = head->next_base - chunk->offset;
+    head->next_base += arena_chunk_span(chunk) - chunk->offset;
+    arena_spare_push(head, head->active);
+    head->active = chunk;
+}
+
+static Arena* arena_grow(Arena* head, size_t size, size_t alignment) {
+    size_t required = size + alignment - 1;
+    if (required < size) {
+        fprintf(stderr, "Arena: Allocation size overflow\n");
+        return NULL;
+    }
+
+    size_t i = 0;
+    while (i < head->spare_count) {
+        Arena* spare = head->spares[i];
+        size_t free_bytes = arena_chunk_free(spare);
+        if (free_bytes >= required && spare->reuse_mark == 0) {
+            head->spares[i] = head->spares[--head->spare_count];
+            arena_spare_reuse(head, spare);
+            return spare;
+        }
+        if (free_bytes < ARENA_SPARE_MIN_FREE || spare->reuse_mark != 0) {
+            head->spares[i] = head->spares[--head->spare_count];
+        } else {
+            i++;
+        }
+    }
+
+    Arena* active = head->active;
+    bool dedicated = size >= active->size / ARENA_DEDICATED_DIVISOR;
+
+    Arena* chunk = NULL;
+    Arena* last = head;
+    for (Arena* current = head; current != NULL; current = current->next) {
+        if (!chunk && current != active && current->offset == 0 && current->high_offset == 0 &&
+            current->size >= required) {
+            chunk = current;
+        }
+        last = current;
+    }
+
+    if (!chunk) {
+        size_t new_arena_size = dedicated ? required : active->size * 2;
+        if (new_arena_size < required) {
+            new_arena_size = required * 2;
+        }
+
+        chunk = arena_chunk_create(head, new_arena_size);
+        if (!chunk) {
+            fprintf(stderr, "Arena: Failed to grow arena\n");
+            return NULL;
+        }
+
+        chunk->head = head;
+        if (dedicated) {
+            chunk->next = active->next;
+            active->next = chunk;
+        } else {
+            last->next = chunk;
+        }
+    } else if (dedicated && chunk->size - required >= ARENA_SPARE_MIN_FREE) {
+        arena_spare_push(head, chunk);
+    }
+
+    chunk->owner = NULL;
+    chunk->reuse_mark = 0;
+
+    if (dedicated) {
+        chunk->owner = active;
+        chunk->owner_base = active->base;
+        chunk->base = arena_split_active(head, arena_chunk_span(chunk));
+        chunk->owner_mark = chunk->base;
+    } else {
+        chunk->base = head->next_base;
+        head->next_base += arena_chunk_span(chunk);
+        arena_spare_push(head, active);
+        head->active = chunk;
+    }
+
+    return chunk;
+}
+
+static void* arena_bump(Arena* chunk, size_t size, size_t alignment) {
+    size_t current_ptr = (size_t)chunk->memory + chunk->offset;
+    size_t aligned_ptr = align_forward(current_ptr, alignment);
+    size_t padding = aligned_ptr - current_ptr;
+
+    if (chunk->offset + padding + size > chunk->size - chunk->high_offset) {
+        return NULL;
+    }
+
+    chunk->offset += padding + size;
+    chunk->allocation_count++;
+    chunk->total_allocated += size + padding;
+
+    if (chunk->offset > chunk->peak_usage) {
+        chunk->peak_usage = chunk->offset;
+    }
+
+    return (void*)aligned_ptr;
+}
+
+static void* arena_bump_down(Arena* chunk, size_t size, size_t alignment) {
+    uintptr_t start = (uintptr_t)chunk->memory;
+    uintptr_t end = start + chunk->size;
+    uintptr_t ptr = (end - chunk->offset - size) & ~(uintptr_t)(alignment - 1);
+
+    if (size > chunk->size - chunk->offset || ptr < start) {
+        return NULL;
+    }
+
+    size_t offset = end - ptr;
+    chunk->total_allocated += offset - chunk->offset;
+    chunk->offset = offset;
+    chunk->allocation_count++;
+
+    if (offset > chunk->peak_usage) {
+        chunk->peak_usage = offset;
+    }
+
+    return (void*)ptr;
+}
+
+static bool arena_contiguous_grow(Arena* head, size_t extra) {
+    size_t required = head->offset + head->high_offset + extra;
+    if (required < extra) {
+        fprintf(stderr, "Arena: Allocation size overflow\n");
+        return false;
+    }
+
+    size_t new_size = head->size * 2;
+    if (new_size < required) {
+        new_size = required * 2;
+    }
+    size_t limit = head->reserved;
+    if (head->memory_kind == ARENA_MEMORY_FILE) {
+        limit -= ((ArenaFileHeader*)head->file_header)->header_size;
+    }
+    if (new_size > limit && required <= limit) {
+        new_size = limit;
+    }
+    return arena_resize(head, new_size) != ARENA_RESIZE_FAILED;
+}
+
+static void* arena_alloc_slow(Arena* head, size_t size, size_t alignment) {
+    if (head->contiguous) {
+        if (size + alignment - 1 < size || !arena_contiguous_grow(head, size + alignment - 1)) {
+            return NULL;
+        }
+        return arena_bump(head, size, alignment);
+    }
+
+    if (head->huge_threshold && size >= head->huge_threshold && alignment <= arena_page_size()) {
+        return arena_huge_alloc(head, size, alignment);
+    }
+
+    Arena* active = head->active;
+    if ((active->memory_kind == ARENA_MEMORY_RESERVED || active->memory_kind == ARENA_MEMORY_CUSTOM) &&
+        !head->bump_down && active->high_offset == 0) {
+        size_t required = active->offset + size + alignment - 1;
+        size_t new_size = active->size * 2 > required ? active->size * 2 : required;
+        if (active->memory_kind == ARENA_MEMORY_CUSTOM && new_size > active->reserved && required <= active->reserved) {
+            new_size = active->reserved;
+        }
+        if (required > active->offset && arena_chunk_grow(active, new_size) != ARENA_RESIZE_FAILED) {
+            return arena_bump(active, size, alignment);
+        }
+    }
+
+    Arena* chunk = arena_grow(head, size, alignment);
+    if (!chunk) {
+        return NULL;
+    }
+
+    return head->bump_down ? arena_bump_down(chunk, size, alignment) : arena_bump(chunk, size, alignment);
+}
+
+static void* arena_alloc(Arena* self, size_t size) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    Arena* head = self->head;
+    if (head->hole_mask) {
+        void* hole = arena_hole_take(head, size);
+        if (hole) {
+            head->allocation_count++;
+            head->total_allocated += size;
+            return hole;
+        }
+    }
+
+    Arena* chunk = head->active;
+    if (chunk->offset + size <= chunk->size - chunk->high_offset) {
+        void* ptr = (uint8_t*)chunk->memory + chunk->offset;
+        chunk->offset += size;
+        chunk->allocation_count++;
+        chunk->total_allocated += size;
+
+        if (chunk->offset > chunk->peak_usage) {
+            chunk->peak_usage = chunk->offset;
+        }
+
+        return ptr;
+    }
+
+    return arena_alloc_slow(head, size, 1);
+}
+
+static void* arena_alloc_aligned(Arena* self, size_t size, size_t alignment) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    if (!is_power_of_two(alignment)) {
+        fprintf(stderr, "Arena: Alignment must be a power of 2\n");
+        return NULL;
+    }
+
+    Arena* head = self->head;
+    void* ptr = arena_bump(head->active, size, alignment);
+    if (ptr) {
+        return ptr;
+    }
+
+    return arena_alloc_slow(head, size, alignment);
+}
+
+static void* arena_alloc_down(Arena* self, size_t size) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    Arena* head = self->head;
+    if (head->hole_mask) {
+        void* hole = arena_hole_take(head, size);
+        if (hole) {
+            head->allocation_count++;
+            head->total_allocated += size;
+            return hole;
+        }
+    }
+
+    Arena* chunk = head->active;
+    uintptr_t start = (uintptr_t)chunk->memory;
+    uintptr_t cur = start + chunk->size - chunk->offset;
+    if (size <= cur - start) {
+        chunk->offset += size;
+        chunk->allocation_count++;
+        chunk->total_allocated += size;
+
+        if (chunk->offset > chunk->peak_usage) {
+            chunk->peak_usage = chunk->offset;
+        }
+
+        return (void*)(cur - size);
+    }
+
+    return arena_alloc_slow(head, size, 1);
+}
+
+static void* arena_alloc_aligned_down(Arena* self, size_t size, size_t alignment) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    if (!is_power_of_two(alignment)) {
+        fprintf(stderr, "Arena: Alignment must be a power of 2\n");
+        return NULL;
+    }
+
+    Arena* head = self->head;
+    void* ptr = arena_bump_down(head->active, size, alignment);
+    if (ptr) {
+        return ptr;
+    }
+
+    return arena_alloc_slow(head, size, alignment);
+}
+
+static bool arena_in_high(Arena* head, const void* ptr) {
+    for (Arena* current = head; current != NULL; current = current->next) {
+        uintptr_t end = (uintptr_t)current->memory + current->size;
+        if (current->high_offset > 0 && (uintptr_t)ptr < end && (uintptr_t)ptr >= end - current->high_offset) {
+            return true;
+        }
+        if (current == head->high_chunk) {
+            break;
+        }
+    }
+    return false;
+}
+
+static void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size) {
+    if (!self) {
+        return NULL;
+    }
+
+    if (ptr == NULL) {
+        return arena_alloc(self, new_size);
+    }
+
+    if (new_size == 0) {
+        return NULL;
+    }
+
+    if (self->head->huge) {
+        ArenaHuge** link = arena_huge_find(self->head, ptr);
+        if (link) {
+            return arena_huge_realloc(self->head, link, new_size);
+        }
+    }
+
+    Arena* chunk = self->head->active;
+    void* expected_ptr = (uint8_t*)chunk->memory + (chunk->offset - old_size);
+    if (ptr == expected_ptr) {
+        size_t start = chunk->offset - old_size;
+        if (start + new_size > chunk->size - chunk->high_offset && chunk->contiguous) {
+            arena_contiguous_grow(chunk, new_size - old_size);
+        }
+        if (start + new_size <= chunk->size - chunk->high_offset) {
+            chunk->offset = start + new_size;
+            if (chunk->offset > chunk->peak_usage) {
+                chunk->peak_usage = chunk->offset;
+            }
+            return ptr;
+        }
+    }
+
+    void* new_ptr = arena_alloc(self, new_size);
+    if (new_ptr) {
+        size_t copy_size = old_size < new_size ? old_size : new_size;
+        memcpy(new_ptr, ptr, copy_size);
+        if (!arena_in_high(self->head, ptr)) {
+            arena_hole_push(self->head, ptr, old_size);
+        }
+    }
+
+    return new_ptr;
+}
+
+static void* arena_realloc_down(Arena* self, void* ptr, size_t old_size, size_t new_size) {
+    if (!self) {
+        return NULL;
+    }
+
+    if (ptr == NULL) {
+        return arena_alloc_down(self, new_size);
+    }
+
+    if (new_size == 0) {
+        return NULL;
+    }
+
+    if (self->head->huge) {
+        ArenaHuge** link = arena_huge_find(self->head, ptr);
+        if (link) {
+            return arena_huge_realloc(self->head, link, new_size);
+        }
+    }
+
+    Arena* chunk = self->head->active;
+    uintptr_t start = (uintptr_t)chunk->memory;
+    uintptr_t end = start + chunk->size;
+    uintptr_t cur = end - chunk->offset;
+    if ((uintptr_t)ptr == cur && old_size <= chunk->offset) {
+        uintptr_t alignment = cur & (~cur + 1);
+        if (alignment > 16) {
+            alignment = 16;
+        }
+        uintptr_t base = cur + old_size;
+        if (new_size <= base - start) {
+            uintptr_t moved = (base - new_size) & ~(alignment - 1);
+            if (moved >= start) {
+                memmove((void*)moved, ptr, old_size < new_size ? old_size : new_size);
+                chunk->offset = end - moved;
+                if (chunk->offset > chunk->peak_usage) {
+                    chunk->peak_usage = chunk->offset;
+                }
+                return (void*)moved;
+            }
+        }
+    }
+
+    void* new_ptr = arena_alloc_down(self, new_size);
+    if (new_ptr) {
+        size_t copy_size = old_size < new_size ? old_size : new_size;
+        memcpy(new_ptr, ptr, copy_size);
+        arena_hole_push(self->head, ptr, old_size);
+    }
+
+    return new_ptr;
+}
+
+static bool arena_free_last(Arena* self, void* ptr, size_t size) {
+    if (!self || !ptr) {
+        return false;
+    }
+
+    uintptr_t addr = (uintptr_t)ptr;
+    Arena* current = self->head;
+    while (current != NULL) {
+        uintptr_t start = (uintptr_t)current->memory;
+        if (current->bump_down) {
+            uintptr_t end = start + current->size;
+            if (addr >= start && addr <= end) {
+                if (addr != end - current->offset || size > current->offset) {
+                    return false;
+                }
+                current->offset -= size;
+                return true;
+            }
+        } else if (addr >= start && addr <= start + current->offset) {
+            if (addr + size != start + current->offset) {
+                return false;
+            }
+            current->offset = addr - start;
+            return true;
+        }
+        current = current->next;
+    }
+
+    return false;
+}
+
+static double arena_now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void arena_retain(Arena* head) {
+    size_t held = 0;
+    size_t demand = 0;
+    for (Arena* current = head; current != NULL; current = current->next) {
+        held += current->size;
+        if (current->offset > 0 || current->high_offset > 0 || current == head) {
+            demand += current->size;
+        }
+    }
+
+    size_t floor = demand > head->retain_target ? demand : head->retain_target;
+    size_t limit = head->retain_limit;
+    if (limit > held) {
+        limit = held;
+    }
+    if (limit < floor) {
+        limit = floor;
+    }
+
+    size_t excess = limit - floor;
+    if (head->retain_decay_ms > 0.0) {
+        double now = arena_now_ms();
+        double elapsed = head->retain_stamp > 0.0 ? now - head->retain_stamp : 0.0;
+        head->retain_stamp = now;
+        if (elapsed >= head->retain_decay_ms) {
+            limit = floor;
+        } else {
+            limit -= (size_t)(excess * (elapsed / head->retain_decay_ms));
+        }
+    } else if (head->retain_decay_resets > 1) {
+        limit -= (excess + head->retain_decay_resets - 1) / head->retain_decay_resets;
+    } else {
+        limit = floor;
+    }
+    head->retain_limit = limit;
+
+    for (int pass = 0; pass < 2; pass++) {
+        while (held > limit) {
+            Arena* victim = NULL;
+            Arena* victim_prev = NULL;
+            for (Arena* prev = head; prev->next != NULL; prev = prev->next) {
+                Arena* chunk = prev->next;
+                if (pass == 0 && (chunk->offset > 0 || chunk->high_offset > 0)) {
+                    continue;
+                }
+                bool enough = held - chunk->size <= limit;
+                bool victim_enough = victim && held - victim->size <= limit;
+                if (!victim || (enough && (!victim_enough || chunk->size < victim->size)) ||
+                    (!enough && !victim_enough && chunk->size > victim->size)) {
+                    victim = chunk;
+                    victim_prev = prev;
+                }
+            }
+            if (!victim) {
+                break;
+            }
+
+            victim_prev->next = victim->next;
+            held -= victim->size;
+            head->released_bytes += victim->size;
+            arena_chunk_release(victim);
+            free(victim);
+        }
+    }
+}
+
+static size_t arena_usage(Arena* head) {
+    size_t usage = 0;
+    for (Arena* current = head; current != NULL; current = current->next) {
+        usage += current->offset + current->high_offset;
+    }
+    return usage;
+}
+
+static size_t arena_adapt_record(Arena* head, size_t usage) {
+    if (head->usage_average == 0) {
+        head->usage_average = usage;
+    } else if (usage > head->usage_average) {
+        head->usage_average += (usage - head->usage_average) >> ARENA_ADAPT_SHIFT;
+    } else {
+        head->usage_average -= (head->usage_average - usage) >> ARENA_ADAPT_SHIFT;
+    }
+
+    if (head->profile) {
+        head->profile->usage_average = head->usage_average;
+        head->profile->samples++;
+    }
+
+    return arena_adapt_estimate(head->usage_average);
+}
+
+static void arena_adapt(Arena* head) {
+    size_t target = arena_adapt_record(head, arena_usage(head));
+    if (target == 0) {
+        return;
+    }
+
+    if (target > head->size || target < head->size / 2) {
+        bool custom = head->memory_kind == ARENA_MEMORY_CUSTOM;
+        void* memory = custom ? arena_backing_acquire(&head->backing, target, target) : malloc(target);
+        if (memory) {
+            arena_chunk_release(head);
+            head->memory = memory;
+            head->memory_kind = custom ? ARENA_MEMORY_CUSTOM : ARENA_MEMORY_HEAP;
+            head->serial = arena_next_serial();
+            head->reserved = custom ? target : 0;
+            head->size = target;
+            head->peak_usage = 0;
+        }
+    }
+
+    if (head->size >= target) {
+        while (head->next != NULL) {
+            Arena* chunk = head->next;
+            head->next = chunk->next;
+            head->released_bytes += chunk->size;
+            arena_chunk_release(chunk);
+            free(chunk);
+        }
+    }
+}
+
+static void arena_reset(Arena* self) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+    arena_hole_clear(head);
+    arena_huge_release(head, 0);
+    head->snapshot_slot_count = 0;
+    if (head->retain_target != ARENA_RETAIN_ALL) {
+        arena_retain(head);
+    }
+    if (head->adaptive) {
+        arena_adapt(head);
+    }
+    head->high_chunk = head;
+    head->active = head;
+    head->spare_count = 0;
+    size_t base = 0;
+    Arena* current = head;
+    while (current != NULL) {
+        current->offset = 0;
+        current->high_offset = 0;
+        current->allocation_count = 0;
+        current->base = base;
+        current->owner = NULL;
+        current->reuse_mark = 0;
+        base += arena_chunk_span(current);
+        current = current->next;
+    }
+    head->next_base = base;
+}
+
+static void arena_reset_to_mark(Arena* self, size_t mark) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+    arena_hole_clear(head);
+    arena_huge_release(head, mark);
+    Arena* active = NULL;
+    Arena* current = head;
+
+    for (; current != NULL; current = current->next) {
+        if (current->reuse_mark && mark <= current->reuse_mark) {
+            if (current->reuse_base < current->base) {
+                current->base = current->reuse_base;
+            }
+            if (current->offset > current->reuse_offset) {
+                current->offset = current->reuse_offset;
+            }
+            current->reuse_mark = 0;
+        }
+        if (current->owner && mark <= current->owner_mark) {
+            if (current->owner_base < current->owner->base) {
+                current->owner->base = current->owner_base;
+            }
+            current->owner = NULL;
+        }
+    }
+
+    current = head;
+    while (current != NULL) {
+        if (mark <= current->base) {
+            current->offset = 0;
+            current->allocation_count = 0;
+        } else if (mark - current->base < current->offset) {
+            current->offset = mark - current->base;
+        }
+
+        if ((!current->owner || current->reuse_mark) && current->base <= mark &&
+            mark - current->base <= current->size && (!active || mark - active->base == active->size)) {
+            active = current;
+        }
+
+        current = current->next;
+    }
+
+    head->active = active ? active : head;
+    size_t i = 0;
+    while (i < head->spare_count) {
+        if (head->spares[i]->base >= head->active->base) {
+            head->spares[i] = head->spares[--head->spare_count];
+        } else {
+            i++;
+        }
+    }
+
+    if (head->snapshot_slot_count > 0) {
+        arena_snapshot_prune(head);
+    }
+}
+
+static size_t arena_get_mark(Arena* self) {
+    if (!self) {
+        return 0;
+    }
+
+    Arena* active = self->head->active;
+    return active->base + active->offset;
+}
+
+static void* arena_alloc_high(Arena* self, size_t size) {
+    return arena_alloc_high_aligned(self, size, 1);
+}
+
+static void* arena_alloc_high_aligned(Arena* self, size_t size, size_t alignment) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    if (!is_power_of_two(alignment)) {
+        fprintf(stderr, "Arena: Alignment must be a power of 2\n");
+        return NULL;
+    }
+
+    Arena* head = self->head;
+    if (head->bump_down) {
+        fprintf(stderr, "Arena: High-end allocation is not available on a bump-down arena\n");
+        return NULL;
+    }
+
+    Arena* chunk = head->high_chunk;
+    uintptr_t start = (uintptr_t)chunk->memory;
+    uintptr_t low = start + chunk->offset;
+    uintptr_t top = start + chunk->size - chunk->high_offset;
+
+    if (top - low >= size && ((top - size) & ~(uintptr_t)(alignment - 1)) >= low) {
+        uintptr_t ptr = (top - size) & ~(uintptr_t)(alignment - 1);
+        chunk->high_offset = start + chunk->size - ptr;
+        chunk->allocation_count++;
+        chunk->total_allocated += top - ptr;
+        return (void*)ptr;
+    }
+
+    size_t new_arena_size = head->size * 2;
+    size_t required_size = size + alignment;
+    if (new_arena_size < required_size) {
+        new_arena_size = required_size * 2;
+    }
+
+    Arena* new_chunk = head->memory_kind == ARENA_MEMORY_CUSTOM ? Arena_create_ex(new_arena_size, 0, &head->backing)
+                                                                 : Arena_create(new_arena_size);
+    if (!new_chunk) {
+        fprintf(stderr, "Arena: Failed to grow arena\n");
+        return NULL;
+    }
+
+    new_chunk->head = head;
+    new_chunk->next = NULL;
+    new_chunk->base = head->next_base;
+    head->next_base += arena_chunk_span(new_chunk);
+
+    Arena* current = head;
+    while (current->next != NULL) {
+        current = current->next;
+    }
+    current->next = new_chunk;
+    head->high_chunk = new_chunk;
+
+    return arena_alloc_high_aligned(new_chunk, size, alignment);
+}
+
+static void arena_reset_high(Arena* self) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+    head->high_chunk = head;
+    Arena* current = head;
+    while (current != NULL) {
+        current->high_offset = 0;
+        current = current->next;
+    }
+}
+
+static void arena_reset_high_to_mark(Arena* self, size_t mark) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+    Arena* current = head;
+    size_t cumulative = 0;
+    bool found = false;
+
+    Arena* active = head->high_chunk;
+    while (current != NULL) {
+        if (found) {
+            current->high_offset = 0;
+        } else if (mark <= cumulative + current->high_offset || current == active) {
+            if (mark - cumulative < current->high_offset) {
+                current->high_offset = mark - cumulative;
+            }
+            head->high_chunk = current;
+            found = true;
+        } else {
+            cumulative += current->high_offset;
+        }
+        current = current->next;
+    }
+}
+
+static size_t arena_get_high_mark(Arena* self) {
+    if (!self) {
+        return 0;
+    }
+
+    Arena* head = self->head;
+    Arena* current = head;
+    size_t cumulative = 0;
+
+    while (current != NULL) {
+        cumulative += current->high_offset;
+        if (current == head->high_chunk) {
+            break;
+        }
+        current = current->next;
+    }
+
+    return cumulative;
+}
+
+static ArenaResizeResult arena_chunk_shrink(Arena* self, size_t new_size) {
+    size_t top = self->bump_down ? self->offset : self->high_offset;
+    if (top > 0) {
+        memmove((uint8_t*)self->memory + new_size - top,
+                (uint8_t*)self->memory + self->size - top, top);
+    }
+
+#ifdef ARENA_HAS_MMAP
+    size_t page = arena_page_size();
+    size_t keep = align_forward(new_size, page);
+    size_t committed = align_forward(self->size, page);
+    if (self->memory_kind == ARENA_MEMORY_RESERVED && keep < committed) {
+        madvise((uint8_t*)self->memory + keep, committed - keep, MADV_DONTNEED);
+        mprotect((uint8_t*)self->memory + keep, committed - keep, PROT_NONE);
+    }
+#endif
+
+    if (self->reserved < self->size) {
+        self->reserved = self->size;
+    }
+    self->size = new_size;
+    return ARENA_RESIZE_IN_PLACE;
+}
+
+static ArenaResizeResult arena_chunk_append(Arena* self, size_t extra) {
+    Arena* head = self->head;
+    Arena* chunk = arena_chunk_create(head, extra);
+    if (!chunk) {
+        fprintf(stderr, "Arena: Failed to resize arena\n");
+        return ARENA_RESIZE_FAILED;
+    }
+
+    Arena* last = head;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    last->next = chunk;
+    chunk->head = head;
+    chunk->base = head->next_base;
+    head->next_base += arena_chunk_span(chunk);
+
+    if (self == head->active) {
+        arena_spare_push(head, self);
+        head->active = chunk;
+    } else {
+        arena_spare_push(head, chunk);
+    }
+
+    return ARENA_RESIZE_APPENDED;
+}
+
+static ArenaResizeResult arena_resize(Arena* self, size_t new_size) {
+    if (!self || new_size == 0) {
+        return ARENA_RESIZE_FAILED;
+    }
+
+    if (new_size < self->offset + self->high_offset) {
+        fprintf(stderr, "Arena: Cannot resize to smaller than current usage\n");
+        return ARENA_RESIZE_FAILED;
+    }
+
+    if (new_size <= self->size) {
+        if (self->memory_kind == ARENA_MEMORY_FILE) {
+            fprintf(stderr, "Arena: File-backed arena cannot shrink\n");
+            return ARENA_RESIZE_FAILED;
+        }
+        return arena_chunk_shrink(self, new_size);
+    }
+
+    size_t top = self->bump_down ? self->offset : self->high_offset;
+    if (top == 0 || self->contiguous) {
+        ArenaResizeResult result = arena_chunk_grow(self, new_size);
+        if (result != ARENA_RESIZE_FAILED) {
+            return result;
+        }
+    }
+
+    if (self->memory_kind == ARENA_MEMORY_FILE) {
+        return ARENA_RESIZE_FAILED;
+    }
+
+    if (self->contiguous) {
+        fprintf(stderr, "Arena: Contiguous arena cannot grow past its reservation\n");
+        return ARENA_RESIZE_FAILED;
+    }
+
+    return arena_chunk_append(self, new_size - self->size);
+}
+
+static void arena_print_stats(Arena* self) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+
+    printf("\n=== Arena Statistics ===\n");
+
+    size_t total_size = 0;
+    size_t total_used = 0;
+    size_t total_allocations = 0;
+    size_t total_tail_waste = 0;
+    size_t chunk_count = 0;
+
+    Arena* current = head;
+    while (current != NULL) {
+        chunk_count++;
+        total_size += current->size;
+        total_used += current->offset + current->high_offset;
         total_allocations += current->allocation_count;
 
-        printf("Chunk %zu:\n", chunk_count);
-        printf("  Size: %zu bytes\n", current->size);
-        printf("  Used: %zu bytes (%.2f%%)\n",
-               current->offset,
-               (current->offset * 100.0) / current->size);
-        printf("  Peak: %zu bytes\n", current->peak_usage);
-        printf("  Allocations: %zu\n", current->allocation_count);
+        printf("Chunk %zu:\n", chunk_count);
+        printf("  Size: %zu bytes\n", current->size);
+        printf("  Used: %zu bytes (%.2f%%)\n",
+               current->offset,
+               (current->offset * 100.0) / current->size);
+        if (current->high_offset > 0) {
+            printf("  High End: %zu bytes\n", current->high_offset);
+        }
+        if (current->memory_kind == ARENA_MEMORY_RESERVED ||
+            (current->memory_kind == ARENA_MEMORY_CUSTOM && current->reserved > current->size)) {
+            printf("  Reserved: %zu bytes\n", current->reserved);
+        }
+        if (current == head->active) {
+            printf("  Active: %zu bytes free\n", arena_chunk_free(current));
+        } else if (current->offset > 0 || current->high_offset > 0) {
+            printf("  Tail Waste: %zu bytes\n", arena_chunk_free(current));
+            total_tail_waste += arena_chunk_free(current);
+        }
+        printf("  Peak: %zu bytes\n", current->peak_usage);
+        printf("  Allocations: %zu\n", current->allocation_count);
+
+        current = current->next;
+    }
+
+    printf("\nTotal Summary:\n");
+    printf("  Chunks: %zu\n", chunk_count);
+    printf("  Total Size: %zu bytes\n", total_size);
+    printf("  Total Used: %zu bytes (%.2f%%)\n",
+           total_used,
+           total_size > 0 ? (total_used * 100.0) / total_size : 0.0);
+    printf("  Total Allocations: %zu\n", total_allocations);
+    printf("  Tail Waste: %zu bytes\n", total_tail_waste);
+    if (head->huge_count > 0) {
+        printf("  Huge Regions: %zu (%zu bytes mapped)\n", head->huge_count, head->huge_bytes);
+    }
+    if (head->adaptive) {
+        printf("  Adaptive: %s%s%saverage usage %zu bytes, next size %zu bytes\n",
+               head->profile ? "site '" : "", head->profile ? head->profile->name : "",
+               head->profile ? "', " : "", head->usage_average, arena_adapt_estimate(head->usage_average));
+    }
+    if (head->retain_target != ARENA_RETAIN_ALL) {
+        printf("  Retention: target %zu bytes, limit %zu bytes, %zu bytes released\n",
+               head->retain_target, head->retain_limit, head->released_bytes);
+    }
+    if (head->bump_down) {
+        printf("  Layout: bump-down\n");
+    } else if (head->memory_kind == ARENA_MEMORY_FILE) {
+        printf("  Layout: file-backed, %zu bytes of address space reserved\n", head->reserved);
+    } else if (head->contiguous) {
+        printf("  Layout: contiguous\n");
+    } else if (head->memory_kind == ARENA_MEMORY_CUSTOM) {
+        printf("  Layout: custom backing allocator\n");
+    }
+    if (head->frozen) {
+        printf("  Frozen: read-only\n");
+    }
+    printf("  Realloc Holes: %zu bytes parked, %zu bytes reclaimed\n",
+           head->hole_bytes, head->reclaimed_bytes);
+    printf("========================\n\n");
+}
+
+static bool arena_protect(Arena* head, bool writable) {
+    bool ok = true;
+#ifdef ARENA_HAS_MMAP
+    size_t page = arena_page_size();
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    for (Arena* current = head; current != NULL; current = current->next) {
+        uintptr_t start = align_forward((uintptr_t)current->memory, page);
+        uintptr_t end = (uintptr_t)current->memory + current->size;
+        end = current->memory_kind == ARENA_MEMORY_HEAP || current->memory_kind == ARENA_MEMORY_CUSTOM
+                  ? end & ~(uintptr_t)(page - 1)
+                  : align_forward(end, page);
+        if (end > start) {
+            ok = mprotect((void*)start, end - start, prot) == 0 && ok;
+        }
+    }
+    for (ArenaHuge* huge = (ArenaHuge*)head->huge; huge != NULL; huge = huge->next) {
+        ok = mprotect(huge, huge->length, prot) == 0 && ok;
+    }
+#else
+    (void)head;
+    (void)writable;
+#endif
+    return ok;
+}
+
+static void arena_frozen_error(void) {
+    fprintf(stderr, "Arena: Arena is frozen and read-only\n");
+}
+
+static void* arena_frozen_alloc(Arena* self, size_t size) {
+    (void)self;
+    (void)size;
+    arena_frozen_error();
+    return NULL;
+}
+
+static void* arena_frozen_alloc_aligned(Arena* self, size_t size, size_t alignment) {
+    (void)self;
+    (void)size;
+    (void)alignment;
+    arena_frozen_error();
+    return NULL;
+}
+
+static void* arena_frozen_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size) {
+    (void)self;
+    (void)ptr;
+    (void)old_size;
+    (void)new_size;
+    arena_frozen_error();
+    return NULL;
+}
+
+static bool arena_frozen_free_last(Arena* self, void* ptr, size_t size) {
+    (void)self;
+    (void)ptr;
+    (void)size;
+    arena_frozen_error();
+    return false;
+}
+
+static void arena_frozen_reset(Arena* self) {
+    (void)self;
+    arena_frozen_error();
+}
+
+static void arena_frozen_reset_to_mark(Arena* self, size_t mark) {
+    (void)self;
+    (void)mark;
+    arena_frozen_error();
+}
+
+static ArenaResizeResult arena_frozen_resize(Arena* self, size_t new_size) {
+    (void)self;
+    (void)new_size;
+    arena_frozen_error();
+    return ARENA_RESIZE_FAILED;
+}
+
+bool arena_freeze(Arena* arena, bool prefault) {
+    if (!arena) {
+        return false;
+    }
+
+    Arena* head = arena->head;
+    if (head->frozen) {
+        return true;
+    }
+
+    if (!arena_protect(head, false)) {
+        fprintf(stderr, "Arena: Failed to make arena memory read-only\n");
+        arena_protect(head, true);
+        return false;
+    }
+
+#if defined(ARENA_HAS_MMAP) && defined(MADV_WILLNEED)
+    if (prefault) {
+        size_t page = arena_page_size();
+        for (Arena* current = head; current != NULL; current = current->next) {
+            uintptr_t start = (uintptr_t)current->memory & ~(uintptr_t)(page - 1);
+            size_t length = align_forward((uintptr_t)current->memory + current->size, page) - start;
+#ifdef MADV_POPULATE_READ
+            madvise((void*)start, length, MADV_POPULATE_READ);
+#endif
+            madvise((void*)start, length, MADV_WILLNEED);
+        }
+    }
+#else
+    (void)prefault;
+#endif
+
+    head->frozen = true;
+    head->alloc = arena_frozen_alloc;
+    head->alloc_aligned = arena_frozen_alloc_aligned;
+    head->realloc = arena_frozen_realloc;
+    head->free_last = arena_frozen_free_last;
+    head->reset = arena_frozen_reset;
+    head->reset_to_mark = arena_frozen_reset_to_mark;
+    head->alloc_high = arena_frozen_alloc;
+    head->alloc_high_aligned = arena_frozen_alloc_aligned;
+    head->reset_high = arena_frozen_reset;
+    head->reset_high_to_mark = arena_frozen_reset_to_mark;
+    head->resize = arena_frozen_resize;
+
+    return true;
+}
+
+static void arena_destroy(Arena* self) {
+    if (!self) {
+        return;
+    }
+
+    Arena* head = self->head;
+    if (head->frozen) {
+        arena_protect(head, true);
+    }
+    if (head->adaptive && head->profile) {
+        size_t usage = arena_usage(head);
+        if (usage > 0) {
+            arena_adapt_record(head, usage);
+        }
+    }
+    arena_huge_release(head, 0);
+    free(head->snapshot_slots);
+    Arena* current = head;
+    while (current != NULL) {
+        Arena* next = current->next;
+        arena_chunk_release(current);
+        free(current);
+        current = next;
+    }
+}
+
+typedef struct ArenaSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t pointer_size;
+    uint64_t preferred_base;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t reloc_count;
+    uint64_t root;
+} ArenaSnapshotHeader;
+
+typedef struct ArenaSnapshotRange {
+    uintptr_t address;
+    size_t length;
+    size_t image_offset;
+} ArenaSnapshotRange;
+
+static size_t arena_snapshot_ranges(Arena* head, ArenaSnapshotRange* ranges) {
+    size_t count = 0;
+    for (Arena* current = head; current != NULL; current = current->next) {
+        uintptr_t start = (uintptr_t)current->memory;
+        if (current->bump_down) {
+            if (current->offset > 0) {
+                if (ranges) {
+                    ranges[count].address = start + current->size - current->offset;
+                    ranges[count].length = current->offset;
+                }
+                count++;
+            }
+            continue;
+        }
+        if (current->offset > 0) {
+            if (ranges) {
+                ranges[count].address = start;
+                ranges[count].length = current->offset;
+            }
+            count++;
+        }
+        if (current->high_offset > 0) {
+            if (ranges) {
+                ranges[count].address = start + current->size - current->high_offset;
+                ranges[count].length = current->high_offset;
+            }
+            count++;
+        }
+    }
+
+    for (ArenaHuge* huge = (ArenaHuge*)head->huge; huge != NULL; huge = huge->next) {
+        if (ranges) {
+            ranges[count].address = (uintptr_t)huge + huge->header;
+            ranges[count].length = huge->length - huge->header;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+static ArenaSnapshotRange* arena_snapshot_find(ArenaSnapshotRange* ranges, size_t count, uintptr_t value) {
+    ArenaSnapshotRange* edge = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (value >= ranges[i].address && value - ranges[i].address < ranges[i].length) {
+            return &ranges[i];
+        }
+        if (value == ranges[i].address + ranges[i].length) {
+            edge = &ranges[i];
+        }
+    }
+    return edge;
+}
+
+static bool arena_snapshot_relocate(uint8_t* image, uint64_t** relocs, size_t* reloc_count, size_t* reloc_capacity,
+                                    size_t image_offset, uintptr_t relocated) {
+    if (*reloc_count == *reloc_capacity) {
+        uint64_t* grown = (uint64_t*)realloc(*relocs, *reloc_capacity * 2 * sizeof(uint64_t));
+        if (!grown) {
+            fprintf(stderr, "Arena: Failed to grow snapshot relocation table\n");
+            return false;
+        }
+        *relocs = grown;
+        *reloc_capacity *= 2;
+    }
+
+    memcpy(image + image_offset, &relocated, sizeof(relocated));
+    (*relocs)[(*reloc_count)++] = image_offset;
+    return true;
+}
+
+static int arena_snapshot_compare(const void* a, const void* b) {
+    uint64_t left = *(const uint64_t*)a;
+    uint64_t right = *(const uint64_t*)b;
+    return left < right ? -1 : left > right;
+}
+
+static void arena_snapshot_prune(Arena* head) {
+    size_t count = arena_snapshot_ranges(head, NULL);
+    ArenaSnapshotRange* ranges = (ArenaSnapshotRange*)malloc((count ? count : 1) * sizeof(ArenaSnapshotRange));
+    if (!ranges) {
+        return;
+    }
+    arena_snapshot_ranges(head, ranges);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < head->snapshot_slot_count; i++) {
+        uintptr_t word = (uintptr_t)head->snapshot_slots[i];
+        ArenaSnapshotRange* range = arena_snapshot_find(ranges, count, word);
+        if (range && word + sizeof(void*) <= range->address + range->length) {
+            head->snapshot_slots[kept++] = head->snapshot_slots[i];
+        }
+    }
+    head->snapshot_slot_count = kept;
+    free(ranges);
+}
+
+bool arena_snapshot_add_pointer(Arena* arena, void* slot) {
+    if (!arena || !slot) {
+        return false;
+    }
+
+    Arena* head = arena->head;
+    if (head->snapshot_slot_count == head->snapshot_slot_capacity) {
+        size_t capacity = head->snapshot_slot_capacity ? head->snapshot_slot_capacity * 2 : 64;
+        void** grown = (void**)realloc(head->snapshot_slots, capacity * sizeof(void*));
+        if (!grown) {
+            fprintf(stderr, "Arena: Failed to grow snapshot pointer list\n");
+            return false;
+        }
+        head->snapshot_slots = grown;
+        head->snapshot_slot_capacity = capacity;
+    }
+
+    head->snapshot_slots[head->snapshot_slot_count++] = slot;
+    return true;
+}
+
+bool arena_snapshot_save(Arena* arena, const void* root, const char* path) {
+    if (!arena || !path) {
+        return false;
+    }
+
+    Arena* head = arena->head;
+    size_t count = arena_snapshot_ranges(head, NULL);
+    ArenaSnapshotRange* ranges = (ArenaSnapshotRange*)malloc((count ? count : 1) * sizeof(ArenaSnapshotRange));
+    if (!ranges) {
+        fprintf(stderr, "Arena: Failed to allocate snapshot range table\n");
+        return false;
+    }
+    arena_snapshot_ranges(head, ranges);
+
+    size_t data_size = 0;
+    uintptr_t low = UINTPTR_MAX;
+    uintptr_t high = 0;
+    for (size_t i = 0; i < count; i++) {
+        data_size += (ranges[i].address - data_size) & (ARENA_SNAPSHOT_ALIGN - 1);
+        ranges[i].image_offset = data_size;
+        data_size += ranges[i].length;
+        if (ranges[i].address < low) {
+            low = ranges[i].address;
+        }
+        if (ranges[i].address + ranges[i].length > high) {
+            high = ranges[i].address + ranges[i].length;
+        }
+    }
+
+    uint64_t preferred_base = align_forward((size_t)head->memory, ARENA_SNAPSHOT_PAGE);
+    uint8_t* image = (uint8_t*)calloc(data_size ? data_size : 1, 1);
+    size_t reloc_capacity = 64;
+    size_t reloc_count = 0;
+    uint64_t* relocs = (uint64_t*)malloc(reloc_capacity * sizeof(uint64_t));
+    if (!image || !relocs) {
+        fprintf(stderr, "Arena: Failed to allocate snapshot image\n");
+        free(image);
+        free(relocs);
+        free(ranges);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        memcpy(image + ranges[i].image_offset, (void*)ranges[i].address, ranges[i].length);
+    }
+
+    bool ok = true;
+    if (head->snapshot_scan) {
+        for (size_t i = 0; ok && i < count; i++) {
+            uintptr_t end = ranges[i].address + ranges[i].length;
+            for (uintptr_t word = align_forward(ranges[i].address, sizeof(void*)); ok && word + sizeof(void*) <= end;
+                 word += sizeof(void*)) {
+                uintptr_t value = *(uintptr_t*)word;
+                if (value < low || value > high) {
+                    continue;
+                }
+                ArenaSnapshotRange* target = arena_snapshot_find(ranges, count, value);
+                if (target) {
+                    ok = arena_snapshot_relocate(image, &relocs, &reloc_count, &reloc_capacity,
+                                                 ranges[i].image_offset + (word - ranges[i].address),
+                                                 (uintptr_t)(preferred_base + target->image_offset +
+                                                             (value - target->address)));
+                }
+            }
+        }
+    } else {
+        for (size_t i = 0; ok && i < head->snapshot_slot_count; i++) {
+            uintptr_t word = (uintptr_t)head->snapshot_slots[i];
+            ArenaSnapshotRange* range = arena_snapshot_find(ranges, count, word);
+            if (!range || word + sizeof(void*) > range->address + range->length) {
+                continue;
+            }
+            uintptr_t value;
+            memcpy(&value, (void*)word, sizeof(value));
+            if (value == 0) {
+                continue;
+            }
+            ArenaSnapshotRange* target = arena_snapshot_find(ranges, count, value);
+            if (!target) {
+                fprintf(stderr, "Arena: Snapshot pointer at %p does not point into the arena\n", (void*)word);
+                ok = false;
+                break;
+            }
+            ok = arena_snapshot_relocate(image, &relocs, &reloc_count, &reloc_capacity,
+                                         range->image_offset + (word - range->address),
+                                         (uintptr_t)(preferred_base + target->image_offset + (value - target->address)));
+        }
+        if (ok && reloc_count > 1) {
+            qsort(relocs, reloc_count, sizeof(uint64_t), arena_snapshot_compare);
+            size_t unique = 1;
+            for (size_t i = 1; i < reloc_count; i++) {
+                if (relocs[i] != relocs[unique - 1]) {
+                    relocs[unique++] = relocs[i];
+                }
+            }
+            reloc_count = unique;
+        }
+    }
+    if (!ok) {
+        free(image);
+        free(relocs);
+        free(ranges);
+        return false;
+    }
+
+    ArenaSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ARENA_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = ARENA_SNAPSHOT_VERSION;
+    header.pointer_size = sizeof(void*);
+    header.preferred_base = preferred_base;
+    header.data_offset = align_forward(sizeof(header) + reloc_count * sizeof(uint64_t), ARENA_SNAPSHOT_PAGE);
+    header.data_size = data_size;
+    header.reloc_count = reloc_count;
+
+    if (root) {
+        ArenaSnapshotRange* target = arena_snapshot_find(ranges, count, (uintptr_t)root);
+        if (target) {
+            header.root = preferred_base + target->image_offset + ((uintptr_t)root - target->address);
+        } else {
+            fprintf(stderr, "Arena: Snapshot root does not point into the arena\n");
+            ok = false;
+        }
+    }
+
+    FILE* file = ok ? fopen(path, "wb") : NULL;
+    if (ok && !file) {
+        fprintf(stderr, "Arena: Failed to open snapshot file %s\n", path);
+        ok = false;
+    }
+
+    if (ok) {
+        size_t table_end = sizeof(header) + reloc_count * sizeof(uint64_t);
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(relocs, sizeof(uint64_t), reloc_count, file) == reloc_count;
+        for (size_t i = table_end; ok && i < header.data_offset; i++) {
+            ok = fputc(0, file) != EOF;
+        }
+        ok = ok && fwrite(image, 1, data_size, file) == data_size;
+        ok = fclose(file) == 0 && ok;
+        if (!ok) {
+            fprintf(stderr, "Arena: Failed to write snapshot file %s\n", path);
+        }
+    }
+
+    free(image);
+    free(relocs);
+    free(ranges);
+    return ok;
+}
+
+Arena* Arena_create_from_snapshot(const char* path, void** root) {
+    if (!path) {
+        return NULL;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Arena: Failed to open snapshot file %s\n", path);
+        return NULL;
+    }
+
+    ArenaSnapshotHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, ARENA_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ARENA_SNAPSHOT_VERSION || header.pointer_size != sizeof(void*)) {
+        fprintf(stderr, "Arena: %s is not a compatible arena snapshot\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    uint64_t* relocs = (uint64_t*)malloc((header.reloc_count ? header.reloc_count : 1) * sizeof(uint64_t));
+    if (!relocs || fread(relocs, sizeof(uint64_t), header.reloc_count, file) != header.reloc_count) {
+        fprintf(stderr, "Arena: Failed to read snapshot relocation table\n");
+        free(relocs);
+        fclose(file);
+        return NULL;
+    }
+
+    size_t length = align_forward(header.data_size ? header.data_size : 1, arena_page_size());
+    void* memory = NULL;
+    ArenaMemoryKind memory_kind = ARENA_MEMORY_HEAP;
+#ifdef ARENA_HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        memory = mmap((void*)(uintptr_t)header.preferred_base, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                      (off_t)header.data_offset);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            memory = NULL;
+        } else {
+            memory_kind = ARENA_MEMORY_MAPPED;
+        }
+    }
+#endif
+    if (!memory) {
+        memory = calloc(length, 1);
+        if (!memory || fseek(file, (long)header.data_offset, SEEK_SET) != 0 ||
+            fread(memory, 1, header.data_size, file) != header.data_size) {
+            fprintf(stderr, "Arena: Failed to load snapshot data\n");
+            free(memory);
+            free(relocs);
+            fclose(file);
+            return NULL;
+        }
+    }
+    fclose(file);
+
+    uintptr_t delta = (uintptr_t)memory - (uintptr_t)header.preferred_base;
+    if (delta != 0) {
+        for (uint64_t i = 0; i < header.reloc_count; i++) {
+            uintptr_t value;
+            memcpy(&value, (uint8_t*)memory + relocs[i], sizeof(value));
+            value += delta;
+            memcpy((uint8_t*)memory + relocs[i], &value, sizeof(value));
+        }
+    }
+
+    Arena* self = arena_wrap_memory(memory, length, memory_kind);
+    if (!self) {
+        if (memory_kind == ARENA_MEMORY_MAPPED) {
+            arena_os_unmap(memory, length);
+        } else {
+            free(memory);
+        }
+        free(relocs);
+        return NULL;
+    }
+
+    for (uint64_t i = 0; i < header.reloc_count; i++) {
+        if (!arena_snapshot_add_pointer(self, (uint8_t*)memory + relocs[i])) {
+            break;
+        }
+    }
+    free(relocs);
+
+    self->offset = header.data_size;
+    self->peak_usage = header.data_size;
+    self->snapshot_relocations = delta != 0 ? header.reloc_count : 0;
+    if (root) {
+        *root = header.root ? (void*)(uintptr_t)(header.root + delta) : NULL;
+    }
+
+    return self;
+}
+
+#ifdef ARENA_HAS_MMAP
+static int arena_anonymous_fd(void) {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    return memfd_create("arena", MFD_CLOEXEC);
+#else
+    static unsigned counter = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "/arena-%ld-%u", (long)getpid(), counter++);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+    return fd;
+#endif
+}
+
+static Arena* arena_file_map(int fd, size_t capacity, size_t reserve, bool private_map) {
+    size_t page = arena_page_size();
+    void* reservation = mmap(NULL, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation == MAP_FAILED) {
+        fprintf(stderr, "Arena: Failed to reserve %zu bytes of address space\n", reserve);
+        return NULL;
+    }
+    void* mapped = mmap(reservation, page + capacity, PROT_READ | PROT_WRITE,
+                        (private_map ? MAP_PRIVATE : MAP_SHARED) | MAP_FIXED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        munmap(reservation, reserve);
+        return NULL;
+    }
+
+    Arena* self = arena_wrap_memory((uint8_t*)mapped + page, capacity, ARENA_MEMORY_FILE);
+    if (!self) {
+        munmap(reservation, reserve);
+        return NULL;
+    }
+
+    self->reserved = reserve;
+    self->next_base = reserve;
+    self->file_fd = fd;
+    self->file_header = mapped;
+    self->file_private = private_map;
+    self->contiguous = true;
+
+    return self;
+}
+#endif
+
+Arena* Arena_open_file(const char* path, size_t size, size_t max_size) {
+#ifdef ARENA_HAS_MMAP
+    if (!path || size == 0) {
+        fprintf(stderr, "Arena: File-backed arena needs a path and a nonzero size\n");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to open arena file %s\n", path);
+        return NULL;
+    }
+
+    size_t page = arena_page_size();
+    struct stat info;
+    ArenaFileHeader existing;
+    bool fresh = fstat(fd, &info) == 0 && info.st_size == 0;
+    size_t capacity = align_forward(size, page);
+    if (!fresh) {
+        if (pread(fd, &existing, sizeof(existing), 0) != (ssize_t)sizeof(existing) ||
+            memcmp(existing.magic, ARENA_FILE_MAGIC, sizeof(existing.magic)) != 0 ||
+            existing.version != ARENA_FILE_VERSION || existing.header_size != page ||
+            existing.offset > existing.capacity || (uint64_t)info.st_size < page + existing.capacity) {
+            fprintf(stderr, "Arena: %s is not a compatible arena file\n", path);
+            close(fd);
+            return NULL;
+        }
+        capacity = (size_t)existing.capacity;
+    } else if (ftruncate(fd, (off_t)(page + capacity)) != 0) {
+        fprintf(stderr, "Arena: Failed to size arena file %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t reserve = page + align_forward(max_size > capacity ? max_size : capacity, page);
+    Arena* self = arena_file_map(fd, capacity, reserve, false);
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to map arena file %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    ArenaFileHeader* header = (ArenaFileHeader*)self->file_header;
+    if (fresh) {
+        memset(header, 0, sizeof(*header));
+        memcpy(header->magic, ARENA_FILE_MAGIC, sizeof(header->magic));
+        header->version = ARENA_FILE_VERSION;
+        header->header_size = (uint32_t)page;
+        header->capacity = capacity;
+    }
+
+    self->offset = (size_t)header->offset;
+    self->peak_usage = self->offset;
+
+    return self;
+#else
+    (void)size;
+    (void)max_size;
+    fprintf(stderr, "Arena: File-backed arenas need mmap, cannot open %s\n", path ? path : "");
+    return NULL;
+#endif
+}
+
+Arena* Arena_create_forkable(size_t size, size_t max_size) {
+#ifdef ARENA_HAS_MMAP
+    if (size == 0) {
+        fprintf(stderr, "Arena: Cannot create arena with size 0\n");
+        return NULL;
+    }
+
+    int fd = arena_anonymous_fd();
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to create anonymous file for a forkable arena\n");
+        return NULL;
+    }
+
+    size_t page = arena_page_size();
+    size_t capacity = align_forward(size, page);
+    size_t reserve = page + align_forward(max_size > capacity ? max_size : capacity, page);
+    Arena* self = ftruncate(fd, (off_t)(page + capacity)) == 0 ? arena_file_map(fd, capacity, reserve, false) : NULL;
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to map forkable arena of size %zu\n", size);
+        close(fd);
+        return NULL;
+    }
+
+    ArenaFileHeader* header = (ArenaFileHeader*)self->file_header;
+    memcpy(header->magic, ARENA_FILE_MAGIC, sizeof(header->magic));
+    header->version = ARENA_FILE_VERSION;
+    header->header_size = (uint32_t)page;
+    header->capacity = capacity;
+    self->forkable = true;
+
+    return self;
+#else
+    (void)size;
+    (void)max_size;
+    fprintf(stderr, "Arena: Forkable arenas need mmap\n");
+    return NULL;
+#endif
+}
+
+#ifdef ARENA_HAS_MMAP
+static void arena_fork_copy_dirty(const uint8_t* source, uint8_t* target, size_t length) {
+    size_t page = arena_page_size();
+#ifdef __linux__
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd >= 0) {
+        uint64_t entries[512];
+        size_t pages = length / page;
+        size_t first = (uintptr_t)source / page;
+        bool ok = true;
+        for (size_t i = 0; ok && i < pages; i += 512) {
+            size_t count = pages - i < 512 ? pages - i : 512;
+            ssize_t bytes = (ssize_t)(count * sizeof(uint64_t));
+            ok = pread(fd, entries, (size_t)bytes, (off_t)((first + i) * sizeof(uint64_t))) == bytes;
+            for (size_t j = 0; ok && j < count; j++) {
+                bool present = (entries[j] >> 63) & 1;
+                bool swapped = (entries[j] >> 62) & 1;
+                bool file_page = (entries[j] >> 61) & 1;
+                if (swapped || (present && !file_page)) {
+                    memcpy(target + (i + j) * page, source + (i + j) * page, page);
+                }
+            }
+        }
+        close(fd);
+        if (ok) {
+            return;
+        }
+    }
+#else
+    (void)page;
+#endif
+    memcpy(target, source, length);
+}
+#endif
+
+Arena* arena_fork(Arena* arena) {
+#ifdef ARENA_HAS_MMAP
+    if (!arena || !arena->head->forkable) {
+        fprintf(stderr, "Arena: arena_fork needs an arena from Arena_create_forkable\n");
+        return NULL;
+    }
+
+    Arena* head = arena->head;
+    ArenaFileHeader* header = (ArenaFileHeader*)head->file_header;
+    size_t length = header->header_size + (size_t)header->capacity;
+    header->offset = head->offset;
+
+    if (!head->file_private) {
+        if (mmap(header, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, head->file_fd, 0) == MAP_FAILED) {
+            fprintf(stderr, "Arena: Failed to make arena copy-on-write\n");
+            return NULL;
+        }
+        head->file_private = true;
+        if (head->frozen) {
+            arena_protect(head, false);
+        }
+    }
+
+    int fd = dup(head->file_fd);
+    Arena* child = fd >= 0 ? arena_file_map(fd, (size_t)header->capacity, head->reserved, true) : NULL;
+    if (!child) {
+        fprintf(stderr, "Arena: Failed to map arena fork\n");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+
+    arena_fork_copy_dirty((const uint8_t*)header, (uint8_t*)child->file_header, length);
+    child->forkable = true;
+    child->offset = head->offset;
+    child->high_offset = head->high_offset;
+    child->peak_usage = head->offset;
+
+    return child;
+#else
+    (void)arena;
+    fprintf(stderr, "Arena: Forkable arenas need mmap\n");
+    return NULL;
+#endif
+}
+
+bool arena_sync(Arena* arena, const void* start, size_t length) {
+    if (!arena || arena->head->memory_kind != ARENA_MEMORY_FILE) {
+        fprintf(stderr, "Arena: arena_sync needs a file-backed arena\n");
+        return false;
+    }
+
+#ifdef ARENA_HAS_MMAP
+    Arena* head = arena->head;
+    ArenaFileHeader* header = (ArenaFileHeader*)head->file_header;
+    header->offset = head->offset;
+
+    uintptr_t begin = (uintptr_t)header;
+    uintptr_t end = (uintptr_t)head->memory + (size_t)header->capacity;
+    if (start) {
+        begin = (uintptr_t)start & ~(uintptr_t)(arena_page_size() - 1);
+        end = (uintptr_t)start + length;
+        if (begin < (uintptr_t)head->memory || end > (uintptr_t)head->memory + (size_t)header->capacity) {
+            fprintf(stderr, "Arena: arena_sync range is outside the arena\n");
+            return false;
+        }
+        if (msync(header, header->header_size, MS_SYNC) != 0) {
+            return false;
+        }
+    }
+    return msync((void*)begin, end - begin, MS_SYNC) == 0;
+#else
+    (void)start;
+    (void)length;
+    return false;
+#endif
+}
+
+void arena_file_set_root(Arena* arena, const void* root) {
+    if (!arena || arena->head->memory_kind != ARENA_MEMORY_FILE) {
+        return;
+    }
+
+    Arena* head = arena->head;
+    ArenaFileHeader* header = (ArenaFileHeader*)head->file_header;
+    header->root = root ? (uint64_t)((uintptr_t)root - (uintptr_t)head->memory) + 1 : 0;
+}
+
+void* arena_file_root(Arena* arena) {
+    if (!arena || arena->head->memory_kind != ARENA_MEMORY_FILE) {
+        return NULL;
+    }
+
+    Arena* head = arena->head;
+    ArenaFileHeader* header = (ArenaFileHeader*)head->file_header;
+    return header->root ? (uint8_t*)head->memory + (header->root - 1) : NULL;
+}
+
+typedef struct ArenaCheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t page_size;
+    uint64_t generation;
+    uint64_t table_offset;
+    uint64_t region_count;
+    uint64_t active;
+    uint64_t high_chunk;
+    uint64_t next_base;
+    uint64_t table_checksum;
+    uint64_t checksum;
+} ArenaCheckpointHeader;
+
+typedef struct ArenaCheckpointRecord {
+    uint64_t file_offset;
+    uint64_t length;
+    uint64_t offset;
+    uint64_t high_offset;
+    uint64_t base;
+    uint64_t bump_down;
+    uint64_t huge;
+    uint64_t owner;
+    uint64_t owner_base;
+    uint64_t owner_mark;
+    uint64_t reuse_mark;
+    uint64_t reuse_base;
+    uint64_t reuse_offset;
+    uint64_t spare;
+} ArenaCheckpointRecord;
+
+typedef struct ArenaCheckpointRegion {
+    const Arena* chunk;
+    const ArenaHuge* huge;
+    uint64_t serial;
+    uintptr_t address;
+    size_t length;
+    uintptr_t page_start;
+    uintptr_t protect_start;
+    uintptr_t protect_end;
+    size_t pages;
+    volatile uint8_t* dirty;
+    uint64_t file_offset;
+    uint8_t fresh;
+    bool seen;
+} ArenaCheckpointRegion;
+
+typedef struct ArenaCheckpointFault {
+    uintptr_t page_start;
+    uintptr_t protect_start;
+    uintptr_t protect_end;
+    volatile uint8_t* dirty;
+} ArenaCheckpointFault;
+
+typedef struct ArenaCheckpointFaults {
+    size_t count;
+    ArenaCheckpointFault* entries;
+} ArenaCheckpointFaults;
+
+static bool arena_checkpoint_save(ArenaCheckpoint* self);
+static void arena_checkpoint_print_stats(ArenaCheckpoint* self);
+static void arena_checkpoint_destroy(ArenaCheckpoint* self);
+
+#ifdef ARENA_HAS_MMAP
+static ArenaCheckpoint* volatile arena_checkpoint_tracked = NULL;
+static volatile int arena_checkpoint_lock = 0;
+static volatile size_t arena_checkpoint_faulting = 0;
+static size_t arena_checkpoint_page = 0;
+static bool arena_checkpoint_installed = false;
+static struct sigaction arena_checkpoint_previous_segv;
+static struct sigaction arena_checkpoint_previous_bus;
+
+static void arena_checkpoint_enter(void) {
+    while (__atomic_exchange_n(&arena_checkpoint_lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&arena_checkpoint_lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void arena_checkpoint_leave(void) {
+    __atomic_store_n(&arena_checkpoint_lock, 0, __ATOMIC_RELEASE);
+}
+
+static void arena_checkpoint_quiesce(void) {
+    while (__atomic_load_n(&arena_checkpoint_faulting, __ATOMIC_SEQ_CST)) {
+    }
+}
+
+static void arena_checkpoint_fault(int signo, siginfo_t* info, void* context) {
+    uintptr_t address = (uintptr_t)info->si_addr;
+    __atomic_add_fetch(&arena_checkpoint_faulting, 1, __ATOMIC_SEQ_CST);
+    for (ArenaCheckpoint* checkpoint = __atomic_load_n(&arena_checkpoint_tracked, __ATOMIC_SEQ_CST); checkpoint;
+         checkpoint = __atomic_load_n(&checkpoint->next_tracked, __ATOMIC_SEQ_CST)) {
+        ArenaCheckpointFaults* faults = (ArenaCheckpointFaults*)__atomic_load_n(&checkpoint->faults, __ATOMIC_SEQ_CST);
+        if (!faults || checkpoint->arena->frozen) {
+            continue;
+        }
+        for (size_t i = 0; i < faults->count; i++) {
+            ArenaCheckpointFault* fault = &faults->entries[i];
+            if (address >= fault->protect_start && address < fault->protect_end) {
+                uintptr_t page = address & ~(uintptr_t)(arena_checkpoint_page - 1);
+                fault->dirty[(page - fault->page_start) / arena_checkpoint_page] = 1;
+                mprotect((void*)page, arena_checkpoint_page, PROT_READ | PROT_WRITE);
+                __atomic_sub_fetch(&arena_checkpoint_faulting, 1, __ATOMIC_SEQ_CST);
+                return;
+            }
+        }
+    }
+    __atomic_sub_fetch(&arena_checkpoint_faulting, 1, __ATOMIC_SEQ_CST);
+
+    struct sigaction* previous = signo == SIGBUS ? &arena_checkpoint_previous_bus : &arena_checkpoint_previous_segv;
+    if ((previous->sa_flags & SA_SIGINFO) && previous->sa_sigaction) {
+        previous->sa_sigaction(signo, info, context);
+    } else if (previous->sa_handler != SIG_DFL && previous->sa_handler != SIG_IGN) {
+        previous->sa_handler(signo);
+    } else {
+        sigaction(signo, previous, NULL);
+    }
+}
+
+static bool arena_checkpoint_install(void) {
+    if (arena_checkpoint_installed) {
+        return true;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = arena_checkpoint_fault;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &arena_checkpoint_previous_segv) != 0 ||
+        sigaction(SIGBUS, &action, &arena_checkpoint_previous_bus) != 0) {
+        return false;
+    }
+
+    arena_checkpoint_page = arena_page_size();
+    arena_checkpoint_installed = true;
+    return true;
+}
+
+static bool arena_soft_dirty_read(uintptr_t page_start, size_t pages, uint64_t* entries) {
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t bytes = (ssize_t)(pages * sizeof(uint64_t));
+    bool ok = pread(fd, entries, (size_t)bytes, (off_t)(page_start / arena_page_size() * sizeof(uint64_t))) == bytes;
+    close(fd);
+    return ok;
+}
+
+static void arena_soft_dirty_collect(void) {
+    for (ArenaCheckpoint* checkpoint = arena_checkpoint_tracked; checkpoint; checkpoint = checkpoint->next_tracked) {
+        if (checkpoint->mode != ARENA_CHECKPOINT_SOFT_DIRTY) {
+            continue;
+        }
+        ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)checkpoint->regions;
+        for (size_t i = 0; i < checkpoint->region_count; i++) {
+            ArenaCheckpointRegion* region = &regions[i];
+            uint64_t* entries = (uint64_t*)malloc(region->pages * sizeof(uint64_t));
+            bool read = entries && arena_soft_dirty_read(region->page_start, region->pages, entries);
+            for (size_t page = 0; page < region->pages; page++) {
+                if (!read || ((entries[page] >> 55) & 1)) {
+                    region->dirty[page] = 1;
+                }
+            }
+            free(entries);
+        }
+    }
+}
+
+static bool arena_soft_dirty_clear(void) {
+    arena_soft_dirty_collect();
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write(fd, "4", 1) == 1;
+    close(fd);
+    return ok;
+}
+
+static bool arena_soft_dirty_probe(void) {
+    uint8_t* probe = (uint8_t*)arena_os_map(arena_page_size());
+    if (!probe) {
+        return false;
+    }
+
+    uint64_t entry = 0;
+    probe[0] = 1;
+    bool ok = arena_soft_dirty_clear();
+    probe[0] = 2;
+    ok = ok && arena_soft_dirty_read((uintptr_t)probe, 1, &entry) && ((entry >> 55) & 1);
+    arena_os_unmap(probe, arena_page_size());
+    return ok;
+}
+static ArenaCheckpointRecord* arena_checkpoint_read_table(int fd, ArenaCheckpointHeader* header) {
+    memset(header, 0, sizeof(*header));
+    for (size_t slot = 0; slot < 2; slot++) {
+        ArenaCheckpointHeader candidate;
+        if (pread(fd, &candidate, sizeof(candidate), (off_t)(slot * ARENA_CHECKPOINT_SLOT)) !=
+                (ssize_t)sizeof(candidate) ||
+            memcmp(candidate.magic, ARENA_CHECKPOINT_MAGIC, sizeof(candidate.magic)) != 0 ||
+            candidate.version != ARENA_CHECKPOINT_VERSION || candidate.region_count == 0) {
+            continue;
+        }
+        uint64_t checksum = candidate.checksum;
+        candidate.checksum = 0;
+        if (checksum == arena_hash_bytes(&candidate, sizeof(candidate)) && candidate.generation > header->generation) {
+            *header = candidate;
+        }
+    }
+    if (header->generation == 0) {
+        return NULL;
+    }
+
+    size_t table_bytes = (size_t)header->region_count * sizeof(ArenaCheckpointRecord);
+    ArenaCheckpointRecord* records = (ArenaCheckpointRecord*)malloc(table_bytes);
+    if (!records || pread(fd, records, table_bytes, (off_t)header->table_offset) != (ssize_t)table_bytes ||
+        arena_hash_bytes(records, table_bytes) != header->table_checksum) {
+        free(records);
+        return NULL;
+    }
+    return records;
+}
+
+static bool arena_checkpoint_track(ArenaCheckpoint* self, const Arena* chunk, const ArenaHuge* huge);
+
+static void arena_checkpoint_resume(ArenaCheckpoint* self) {
+    ArenaCheckpointHeader header;
+    ArenaCheckpointRecord* records = arena_checkpoint_read_table(self->fd, &header);
+    if (!records) {
+        if (header.generation == 0) {
+            ftruncate(self->fd, 0);
+        } else {
+            struct stat info;
+            if (fstat(self->fd, &info) == 0) {
+                self->file_end = align_forward((size_t)info.st_size, arena_page_size());
+            }
+            self->generation = header.generation;
+        }
+        return;
+    }
+
+    size_t page = arena_page_size();
+    size_t buffer = (size_t)(header.generation & 1);
+    uint64_t end = align_forward((size_t)(header.table_offset + header.region_count * sizeof(ArenaCheckpointRecord)),
+                                 page);
+    for (uint64_t i = 0; i < header.region_count; i++) {
+        size_t stride = align_forward((size_t)records[i].length, page);
+        uint64_t region_end = records[i].file_offset - buffer * stride + 2 * stride;
+        if (region_end > end) {
+            end = region_end;
+        }
+    }
+
+    size_t matched = 0;
+    const Arena* chunk = self->arena;
+    const ArenaHuge* huge = (const ArenaHuge*)self->arena->huge;
+    while (matched < header.region_count && (chunk || huge)) {
+        const ArenaCheckpointRecord* record = &records[matched];
+        if (record->huge ? (chunk || record->length != huge->length) : (!chunk || record->length != chunk->size)) {
+            break;
+        }
+        if (!arena_checkpoint_track(self, chunk, chunk ? NULL : huge)) {
+            break;
+        }
+        ArenaCheckpointRegion* region = &((ArenaCheckpointRegion*)self->regions)[matched];
+        region->file_offset = record->file_offset - buffer * align_forward(region->length, page);
+        if (chunk) {
+            chunk = chunk->next;
+        } else {
+            huge = huge->next;
+        }
+        matched++;
+    }
+    if (matched != header.region_count || chunk || huge) {
+        ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)self->regions;
+        for (size_t i = 0; i < self->region_count; i++) {
+            free((void*)regions[i].dirty);
+        }
+        self->region_count = 0;
+    } else {
+        self->table_offset[buffer] = header.table_offset;
+        self->table_space[buffer] = align_forward(header.region_count * sizeof(ArenaCheckpointRecord), page);
+    }
+
+    self->file_end = end;
+    self->generation = header.generation;
+    free(records);
+}
+#endif
+
+ArenaCheckpoint* ArenaCheckpoint_create(Arena* arena, const char* path, ArenaCheckpointMode mode) {
+#ifdef ARENA_HAS_MMAP
+    if (!arena || !path) {
+        return NULL;
+    }
+
+    arena_checkpoint_enter();
+    if (mode == ARENA_CHECKPOINT_AUTO) {
+        mode = arena_soft_dirty_probe() ? ARENA_CHECKPOINT_SOFT_DIRTY : ARENA_CHECKPOINT_MPROTECT;
+    } else if (mode == ARENA_CHECKPOINT_SOFT_DIRTY && !arena_soft_dirty_probe()) {
+        arena_checkpoint_leave();
+        fprintf(stderr, "Arena: Soft-dirty page tracking is not available\n");
+        return NULL;
+    }
+    arena_checkpoint_leave();
+    if (mode == ARENA_CHECKPOINT_MPROTECT && !arena_checkpoint_install()) {
+        fprintf(stderr, "Arena: Failed to install the write fault handler\n");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to open checkpoint file %s\n", path);
+        return NULL;
+    }
+
+    ArenaCheckpoint* self = (ArenaCheckpoint*)malloc(sizeof(ArenaCheckpoint));
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to allocate checkpoint struct\n");
+        close(fd);
+        return NULL;
+    }
+
+    self->self = self;
+    self->arena = arena->head;
+    self->mode = mode;
+    self->fd = fd;
+    self->regions = NULL;
+    self->region_count = 0;
+    self->region_capacity = 0;
+    self->faults = NULL;
+    self->file_end = arena_page_size();
+    self->table_offset[0] = 0;
+    self->table_offset[1] = 0;
+    self->table_space[0] = 0;
+    self->table_space[1] = 0;
+    self->generation = 0;
+    self->pages_written = 0;
+    self->pages_used = 0;
+    self->next_tracked = NULL;
+    self->save = arena_checkpoint_save;
+    self->print_stats = arena_checkpoint_print_stats;
+    self->destroy = arena_checkpoint_destroy;
+    arena_checkpoint_resume(self);
+
+    if (mode != ARENA_CHECKPOINT_FULL) {
+        arena_checkpoint_enter();
+        self->next_tracked = arena_checkpoint_tracked;
+        __atomic_store_n(&arena_checkpoint_tracked, self, __ATOMIC_SEQ_CST);
+        arena_checkpoint_leave();
+    }
+
+    return self;
+#else
+    (void)arena;
+    (void)mode;
+    fprintf(stderr, "Arena: Checkpoints need mmap, cannot write %s\n", path ? path : "");
+    return NULL;
+#endif
+}
+
+#ifdef ARENA_HAS_MMAP
+static void arena_checkpoint_unprotect(ArenaCheckpoint* self, ArenaCheckpointRegion* region) {
+    if (region->protect_end > region->protect_start && !self->arena->frozen) {
+        mprotect((void*)region->protect_start, region->protect_end - region->protect_start, PROT_READ | PROT_WRITE);
+    }
+}
+
+static bool arena_checkpoint_track(ArenaCheckpoint* self, const Arena* chunk, const ArenaHuge* huge) {
+    uintptr_t address = chunk ? (uintptr_t)chunk->memory : (uintptr_t)huge;
+    size_t length = chunk ? chunk->size : huge->length;
+    uint64_t serial = chunk ? chunk->serial : huge->serial;
+    ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)self->regions;
+    for (size_t i = 0; i < self->region_count; i++) {
+        if (regions[i].chunk == chunk && regions[i].huge == huge && regions[i].serial == serial &&
+            regions[i].address == address && regions[i].length == length) {
+            regions[i].seen = true;
+            return true;
+        }
+    }
+
+    if (self->region_count == self->region_capacity) {
+        size_t capacity = self->region_capacity ? self->region_capacity * 2 : 8;
+        regions = (ArenaCheckpointRegion*)realloc(self->regions, capacity * sizeof(ArenaCheckpointRegion));
+        if (!regions) {
+            return false;
+        }
+        self->regions = regions;
+        self->region_capacity = capacity;
+    }
+
+    size_t page = arena_page_size();
+    ArenaCheckpointRegion* region = &regions[self->region_count];
+    region->chunk = chunk;
+    region->huge = huge;
+    region->serial = serial;
+    region->address = address;
+    region->length = length;
+    region->page_start = region->address & ~(uintptr_t)(page - 1);
+    region->pages = (align_forward(region->address + region->length, page) - region->page_start) / page;
+    region->protect_start = align_forward(region->address, page);
+    region->protect_end = (region->address + region->length) & ~(uintptr_t)(page - 1);
+    if (!chunk || (chunk->memory_kind != ARENA_MEMORY_HEAP && chunk->memory_kind != ARENA_MEMORY_CUSTOM)) {
+        region->protect_end = align_forward(region->address + region->length, page);
+    }
+    if (self->mode != ARENA_CHECKPOINT_MPROTECT || region->protect_end < region->protect_start) {
+        region->protect_end = region->protect_start;
+    }
+    region->dirty = NULL;
+    if (self->mode != ARENA_CHECKPOINT_FULL) {
+        region->dirty = (volatile uint8_t*)calloc(region->pages, 1);
+        if (!region->dirty) {
+            return false;
+        }
+    }
+    region->file_offset = self->file_end;
+    region->fresh = 2;
+    region->seen = true;
+    self->file_end += 2 * align_forward(region->length, page);
+    self->region_count++;
+    return true;
+}
+
+static bool arena_checkpoint_publish(ArenaCheckpoint* self) {
+    ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)self->regions;
+    ArenaCheckpointFaults* faults = (ArenaCheckpointFaults*)malloc(sizeof(ArenaCheckpointFaults) +
+                                                                   self->region_count * sizeof(ArenaCheckpointFault));
+    if (!faults) {
+        return false;
+    }
+
+    faults->count = 0;
+    faults->entries = (ArenaCheckpointFault*)(faults + 1);
+    for (size_t i = 0; i < self->region_count; i++) {
+        if (regions[i].protect_end > regions[i].protect_start) {
+            ArenaCheckpointFault* fault = &faults->entries[faults->count++];
+            fault->page_start = regions[i].page_start;
+            fault->protect_start = regions[i].protect_start;
+            fault->protect_end = regions[i].protect_end;
+            fault->dirty = regions[i].dirty;
+        }
+    }
+
+    void* previous = __atomic_exchange_n(&self->faults, (void*)faults, __ATOMIC_SEQ_CST);
+    arena_checkpoint_quiesce();
+    free(previous);
+    return true;
+}
+
+static bool arena_checkpoint_flush(ArenaCheckpoint* self, ArenaCheckpointRegion* region, uint64_t file_offset,
+                                   uintptr_t start, uintptr_t end) {
+    while (start < end) {
+        ssize_t written = pwrite(self->fd, (const void*)start, end - start,
+                                 (off_t)(file_offset + (start - region->address)));
+        if (written <= 0) {
+            return false;
+        }
+        start += (uintptr_t)written;
+    }
+    return true;
+}
+
+static bool arena_checkpoint_write_region(ArenaCheckpoint* self, ArenaCheckpointRegion* region, size_t buffer) {
+    const Arena* chunk = region->chunk;
+    size_t page = arena_page_size();
+    uint64_t file_offset = region->file_offset + buffer * align_forward(region->length, page);
+    size_t low_end = region->length;
+    size_t high_start = region->length;
+    if (chunk) {
+        low_end = chunk->bump_down ? 0 : chunk->offset;
+        high_start = region->length - (chunk->bump_down ? chunk->offset : chunk->high_offset);
+    }
+
+    bool ok = true;
+    uintptr_t run_start = 0;
+    uintptr_t run_end = 0;
+    for (size_t i = 0; ok && i < region->pages; i++) {
+        uintptr_t page_address = region->page_start + i * page;
+        uintptr_t start = page_address > region->address ? page_address : region->address;
+        uintptr_t end = page_address + page < region->address + region->length ? page_address + page
+                                                                                : region->address + region->length;
+        size_t first = start - region->address;
+        size_t last = end - region->address;
+        if (first >= low_end && last <= high_start) {
+            continue;
+        }
+        self->pages_used++;
+
+        bool dirty = region->fresh || self->mode == ARENA_CHECKPOINT_FULL;
+        if (region->dirty) {
+            dirty = dirty || region->dirty[i];
+            region->dirty[i] = region->dirty[i] == 1 ? 2 : 0;
+        }
+        if (!dirty && self->mode == ARENA_CHECKPOINT_MPROTECT) {
+            dirty = page_address < region->protect_start || page_address >= region->protect_end;
+        }
+        if (!dirty) {
+            continue;
+        }
+
+        self->pages_written++;
+        if (start != run_end) {
+            ok = arena_checkpoint_flush(self, region, file_offset, run_start, run_end);
+            run_start = start;
+        }
+        run_end = end;
+    }
+    ok = ok && arena_checkpoint_flush(self, region, file_offset, run_start, run_end);
+    return ok;
+}
+
+static uint64_t arena_checkpoint_index(const Arena* head, const Arena* chunk) {
+    uint64_t index = 1;
+    for (const Arena* current = head; current != NULL; current = current->next, index++) {
+        if (current == chunk) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+static bool arena_checkpoint_commit(ArenaCheckpoint* self) {
+    ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)self->regions;
+    for (size_t i = 0; i < self->region_count; i++) {
+        regions[i].seen = false;
+    }
+    for (Arena* chunk = self->arena; chunk != NULL; chunk = chunk->next) {
+        if (!arena_checkpoint_track(self, chunk, NULL)) {
+            fprintf(stderr, "Arena: Failed to grow checkpoint region table\n");
+            return false;
+        }
+    }
+    for (ArenaHuge* huge = (ArenaHuge*)self->arena->huge; huge != NULL; huge = huge->next) {
+        if (!arena_checkpoint_track(self, NULL, huge)) {
+            fprintf(stderr, "Arena: Failed to grow checkpoint region table\n");
+            return false;
+        }
+    }
+
+    regions = (ArenaCheckpointRegion*)self->regions;
+    size_t kept = 0;
+    for (Arena* chunk = self->arena; chunk != NULL; chunk = chunk->next, kept++) {
+        size_t i = kept;
+        while (regions[i].chunk != chunk || !regions[i].seen) {
+            i++;
+        }
+        ArenaCheckpointRegion region = regions[i];
+        regions[i] = regions[kept];
+        regions[kept] = region;
+    }
+    for (ArenaHuge* huge = (ArenaHuge*)self->arena->huge; huge != NULL; huge = huge->next, kept++) {
+        size_t i = kept;
+        while (regions[i].huge != huge || !regions[i].seen) {
+            i++;
+        }
+        ArenaCheckpointRegion region = regions[i];
+        regions[i] = regions[kept];
+        regions[kept] = region;
+    }
+    size_t count = self->region_count;
+    for (size_t i = kept; i < count; i++) {
+        arena_checkpoint_unprotect(self, &regions[i]);
+    }
+    self->region_count = kept;
+    if (self->mode == ARENA_CHECKPOINT_MPROTECT && !arena_checkpoint_publish(self)) {
+        fprintf(stderr, "Arena: Failed to publish checkpoint region table\n");
+        return false;
+    }
+    for (size_t i = kept; i < count; i++) {
+        free((void*)regions[i].dirty);
+    }
+
+    if (self->mode == ARENA_CHECKPOINT_SOFT_DIRTY) {
+        arena_soft_dirty_clear();
+    }
+
+    size_t buffer = (size_t)((self->generation + 1) & 1);
+    bool ok = true;
+    for (size_t i = 0; ok && i < self->region_count; i++) {
+        ok = arena_checkpoint_write_region(self, &regions[i], buffer);
+    }
+    for (size_t i = 0; i < self->region_count; i++) {
+        regions[i].fresh = ok ? (uint8_t)(regions[i].fresh ? regions[i].fresh - 1 : 0) : 2;
+        if (regions[i].protect_end > regions[i].protect_start) {
+            mprotect((void*)regions[i].protect_start, regions[i].protect_end - regions[i].protect_start, PROT_READ);
+        }
+    }
+
+    size_t table_bytes = self->region_count * sizeof(ArenaCheckpointRecord);
+    if (table_bytes > self->table_space[buffer]) {
+        self->table_offset[buffer] = self->file_end;
+        self->table_space[buffer] = align_forward(table_bytes, arena_page_size());
+        self->file_end += self->table_space[buffer];
+    }
+    ArenaCheckpointRecord* records = (ArenaCheckpointRecord*)calloc(self->region_count ? self->region_count : 1,
+                                                                    sizeof(ArenaCheckpointRecord));
+    if (!records) {
+        ok = false;
+    }
+    for (size_t i = 0; ok && i < self->region_count; i++) {
+        const Arena* chunk = regions[i].chunk;
+        const ArenaHuge* huge = regions[i].huge;
+        records[i].file_offset = regions[i].file_offset + buffer * align_forward(regions[i].length, arena_page_size());
+        records[i].length = regions[i].length;
+        if (chunk) {
+            records[i].offset = chunk->offset;
+            records[i].high_offset = chunk->high_offset;
+            records[i].base = chunk->base;
+            records[i].bump_down = chunk->bump_down;
+            records[i].owner = arena_checkpoint_index(self->arena, chunk->owner);
+            records[i].owner_base = chunk->owner_base;
+            records[i].owner_mark = chunk->owner_mark;
+            records[i].reuse_mark = chunk->reuse_mark;
+            records[i].reuse_base = chunk->reuse_base;
+            records[i].reuse_offset = chunk->reuse_offset;
+            for (size_t spare = 0; spare < self->arena->spare_count; spare++) {
+                if (self->arena->spares[spare] == chunk) {
+                    records[i].spare = spare + 1;
+                }
+            }
+            continue;
+        }
+        records[i].offset = huge->header;
+        records[i].base = huge->base;
+        records[i].huge = 1;
+        records[i].owner = arena_checkpoint_index(self->arena, huge->owner);
+        records[i].owner_base = huge->owner_base;
+    }
+
+    ArenaCheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ARENA_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = ARENA_CHECKPOINT_VERSION;
+    header.page_size = (uint32_t)arena_page_size();
+    header.generation = self->generation + 1;
+    header.table_offset = self->table_offset[buffer];
+    header.region_count = self->region_count;
+    header.active = arena_checkpoint_index(self->arena, self->arena->active);
+    header.high_chunk = arena_checkpoint_index(self->arena, self->arena->high_chunk);
+    header.next_base = self->arena->next_base;
+    header.table_checksum = records ? arena_hash_bytes(records, table_bytes) : 0;
+    header.checksum = arena_hash_bytes(&header, sizeof(header));
+
+    ok = ok && pwrite(self->fd, records, table_bytes, (off_t)header.table_offset) == (ssize_t)table_bytes &&
+         fsync(self->fd) == 0 &&
+         pwrite(self->fd, &header, sizeof(header), (off_t)(buffer * ARENA_CHECKPOINT_SLOT)) ==
+             (ssize_t)sizeof(header) &&
+         fsync(self->fd) == 0;
+    free(records);
+
+    if (!ok) {
+        fprintf(stderr, "Arena: Failed to write checkpoint\n");
+        for (size_t i = 0; i < self->region_count; i++) {
+            regions[i].fresh = 2;
+        }
+        return false;
+    }
+
+    self->generation++;
+    return true;
+}
+#endif
+
+static bool arena_checkpoint_save(ArenaCheckpoint* self) {
+#ifdef ARENA_HAS_MMAP
+    if (!self) {
+        return false;
+    }
+
+    arena_checkpoint_enter();
+    bool ok = arena_checkpoint_commit(self);
+    arena_checkpoint_leave();
+    return ok;
+#else
+    (void)self;
+    return false;
+#endif
+}
+
+static void arena_checkpoint_print_stats(ArenaCheckpoint* self) {
+    if (!self) {
+        return;
+    }
+
+    const char* modes[] = {"auto", "full copy", "soft-dirty bits", "mprotect write faults"};
+    printf("\n=== Arena Checkpoint Statistics ===\n");
+    printf("  Tracking: %s\n", modes[self->mode]);
+    printf("  Checkpoints: %llu\n", (unsigned long long)self->generation);
+    printf("  Regions: %zu\n", self->region_count);
+    printf("  Pages Written: %zu of %zu in use (%.2f%%)\n", self->pages_written, self->pages_used,
+           self->pages_used ? (self->pages_written * 100.0) / self->pages_used : 0.0);
+    printf("===================================\n\n");
+}
+
+static void arena_checkpoint_destroy(ArenaCheckpoint* self) {
+    if (!self) {
+        return;
+    }
+
+#ifdef ARENA_HAS_MMAP
+    ArenaCheckpointRegion* regions = (ArenaCheckpointRegion*)self->regions;
+    for (size_t i = 0; i < self->region_count; i++) {
+        arena_checkpoint_unprotect(self, &regions[i]);
+    }
+    arena_checkpoint_enter();
+    for (ArenaCheckpoint* volatile* link = &arena_checkpoint_tracked; *link; link = &(*link)->next_tracked) {
+        if (*link == self) {
+            __atomic_store_n(link, self->next_tracked, __ATOMIC_SEQ_CST);
+            break;
+        }
+    }
+    arena_checkpoint_leave();
+    arena_checkpoint_quiesce();
+    for (size_t i = 0; i < self->region_count; i++) {
+        free((void*)regions[i].dirty);
+    }
+    free(self->faults);
+    close(self->fd);
+#endif
+    free(self->regions);
+    free(self);
+}
+
+#ifdef ARENA_HAS_MMAP
+static Arena* arena_checkpoint_chunk(Arena* head, uint64_t index) {
+    Arena* chunk = index ? head : NULL;
+    for (uint64_t i = 1; chunk != NULL && i < index; i++) {
+        chunk = chunk->next;
+    }
+    return chunk;
+}
+
+static bool arena_checkpoint_restore_huge(int fd, const ArenaCheckpointRecord* record, Arena* head,
+                                          ArenaHuge*** tail) {
+    size_t length = (size_t)record->length;
+    size_t header = (size_t)record->offset;
+    if (!head || header < sizeof(ArenaHuge) || header >= length) {
+        return false;
+    }
+
+    Arena* owner = arena_checkpoint_chunk(head, record->owner);
+    if (!owner) {
+        return false;
+    }
+
+    ArenaHuge* huge = (ArenaHuge*)arena_os_map(length);
+    if (!huge) {
+        return false;
+    }
+    if (pread(fd, (uint8_t*)huge + header, length - header, (off_t)(record->file_offset + header)) !=
+        (ssize_t)(length - header)) {
+        arena_os_unmap(huge, length);
+        return false;
+    }
+
+    huge->next = NULL;
+    huge->length = length;
+    huge->header = header;
+    huge->base = (size_t)record->base;
+    huge->owner = owner;
+    huge->owner_base = (size_t)record->owner_base;
+    huge->serial = arena_next_serial();
+    if (!*tail) {
+        *tail = (ArenaHuge**)&head->huge;
+    }
+    **tail = huge;
+    *tail = &huge->next;
+    head->huge_count++;
+    head->huge_bytes += length;
+    if (huge->base + length > head->next_base) {
+        head->next_base = huge->base + length;
+    }
+    return true;
+}
+#endif
+
+Arena* Arena_create_from_checkpoint(const char* path) {
+#ifdef ARENA_HAS_MMAP
+    int fd = path ? open(path, O_RDONLY) : -1;
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to open checkpoint file %s\n", path ? path : "(null)");
+        return NULL;
+    }
+
+    ArenaCheckpointHeader header;
+    ArenaCheckpointRecord* records = arena_checkpoint_read_table(fd, &header);
+    if (!records) {
+        if (header.generation == 0) {
+            fprintf(stderr, "Arena: %s is not a compatible arena checkpoint\n", path);
+        } else {
+            fprintf(stderr, "Arena: Failed to read checkpoint region table\n");
+        }
+        close(fd);
+        return NULL;
+    }
+
+    Arena* head = NULL;
+    Arena* last = NULL;
+    bool ok = true;
+    ArenaHuge** tail = NULL;
+    for (uint64_t i = 0; ok && i < header.region_count; i++) {
+        ArenaCheckpointRecord* record = &records[i];
+        size_t length = (size_t)record->length;
+        if (record->huge) {
+            ok = arena_checkpoint_restore_huge(fd, record, head, &tail);
+            continue;
+        }
+
+        Arena* chunk = record->bump_down ? Arena_create_bump_down(length) : Arena_create(length);
+        if (!chunk || record->offset + record->high_offset > length) {
+            ok = false;
+            if (chunk) {
+                chunk->destroy(chunk->self);
+            }
+            break;
+        }
+
+        if (!head) {
+            head = chunk;
+        } else {
+            chunk->head = head;
+            last->next = chunk;
+        }
+        last = chunk;
+
+        size_t low = record->bump_down ? 0 : (size_t)record->offset;
+        size_t high = record->bump_down ? (size_t)record->offset : (size_t)record->high_offset;
+        ok = (ssize_t)low == pread(fd, chunk->memory, low, (off_t)record->file_offset) &&
+             (ssize_t)high == pread(fd, (uint8_t*)chunk->memory + length - high, high,
+                                    (off_t)(record->file_offset + length - high));
+
+        chunk->offset = (size_t)record->offset;
+        chunk->high_offset = record->bump_down ? 0 : (size_t)record->high_offset;
+        chunk->peak_usage = chunk->offset;
+        chunk->base = (size_t)record->base;
+        if (chunk->base + length > head->next_base) {
+            head->next_base = chunk->base + length;
+        }
+    }
+    ok = ok && head != NULL;
+
+    size_t spares = 0;
+    for (uint64_t i = 0; ok && i < header.region_count && !records[i].huge; i++) {
+        ArenaCheckpointRecord* record = &records[i];
+        Arena* chunk = arena_checkpoint_chunk(head, i + 1);
+        chunk->owner = arena_checkpoint_chunk(head, record->owner);
+        chunk->owner_base = (size_t)record->owner_base;
+        chunk->owner_mark = (size_t)record->owner_mark;
+        chunk->reuse_mark = (size_t)record->reuse_mark;
+        chunk->reuse_base = (size_t)record->reuse_base;
+        chunk->reuse_offset = (size_t)record->reuse_offset;
+        if (record->spare > ARENA_SPARE_CHUNKS || (record->owner && !chunk->owner)) {
+            ok = false;
+        } else if (record->spare) {
+            spares++;
+            head->spares[record->spare - 1] = chunk;
+            if (record->spare > head->spare_count) {
+                head->spare_count = (size_t)record->spare;
+            }
+        }
+    }
+    if (ok && spares == head->spare_count) {
+        Arena* active = arena_checkpoint_chunk(head, header.active);
+        Arena* high_chunk = arena_checkpoint_chunk(head, header.high_chunk);
+        ok = active != NULL && high_chunk != NULL;
+        head->active = active;
+        head->high_chunk = high_chunk;
+        if (header.next_base > head->next_base) {
+            head->next_base = (size_t)header.next_base;
+        }
+    } else {
+        ok = false;
+    }
+    free(records);
+    close(fd);
+
+    if (!ok) {
+        fprintf(stderr, "Arena: Failed to restore checkpoint %s\n", path);
+        if (head) {
+            head->destroy(head->self);
+        }
+        return NULL;
+    }
+
+    return head;
+#else
+    fprintf(stderr, "Arena: Checkpoints need mmap, cannot read %s\n", path ? path : "");
+    return NULL;
+#endif
+}
+
+
+static void* arena_seglist_push(ArenaSegList* self, const void* element);
+static void* arena_seglist_at(ArenaSegList* self, size_t index);
+static void* arena_seglist_segment(ArenaSegList* self, size_t index, size_t* length);
+static void arena_seglist_clear(ArenaSegList* self);
+
+ArenaSegList* ArenaSegList_create(Arena* arena, size_t element_size, size_t alignment, size_t first_segment) {
+    if (!arena || element_size == 0) {
+        return NULL;
+    }
+
+    if (!is_power_of_two(alignment)) {
+        fprintf(stderr, "Arena: Alignment must be a power of 2\n");
+        return NULL;
+    }
+
+    if (!is_power_of_two(first_segment)) {
+        fprintf(stderr, "Arena: Segment size must be a power of 2\n");
+        return NULL;
+    }
+
+    ArenaSegList* self = (ArenaSegList*)arena->alloc_aligned(arena->self, sizeof(ArenaSegList), sizeof(void*));
+    if (!self) {
+        return NULL;
+    }
+
+    self->self = self;
+    self->arena = arena;
+    self->element_size = element_size;
+    self->stride = align_forward(element_size, alignment);
+    self->alignment = alignment;
+    self->first_shift = 63 - arena_clz64(first_segment);
+    self->count = 0;
+    self->segment_count = 0;
+    self->push = arena_seglist_push;
+    self->at = arena_seglist_at;
+    self->segment = arena_seglist_segment;
+    self->clear = arena_seglist_clear;
+
+    return self;
+}
+
+static void* arena_seglist_push(ArenaSegList* self, const void* element) {
+    if (!self) {
+        return NULL;
+    }
+
+    size_t biased = self->count + ((size_t)1 << self->first_shift);
+    size_t top_bit = 63 - arena_clz64(biased);
+    size_t segment = top_bit - self->first_shift;
+
+    if (segment >= self->segment_count) {
+        if (segment >= ARENA_SEGLIST_MAX_SEGMENTS) {
+            fprintf(stderr, "Arena: Segmented list is full\n");
+            return NULL;
+        }
+        size_t capacity = (size_t)1 << top_bit;
+        void* memory = self->arena->alloc_aligned(self->arena->self, capacity * self->stride, self->alignment);
+        if (!memory) {
+            return NULL;
+        }
+        self->segments[self->segment_count++] = memory;
+    }
+
+    void* slot = (uint8_t*)self->segments[segment] + (biased - ((size_t)1 << top_bit)) * self->stride;
+    if (element) {
+        memcpy(slot, element, self->element_size);
+    }
+    self->count++;
+
+    return slot;
+}
+
+static void* arena_seglist_at(ArenaSegList* self, size_t index) {
+    if (!self || index >= self->count) {
+        return NULL;
+    }
+
+    size_t biased = index + ((size_t)1 << self->first_shift);
+    size_t top_bit = 63 - arena_clz64(biased);
+
+    return (uint8_t*)self->segments[top_bit - self->first_shift] + (biased - ((size_t)1 << top_bit)) * self->stride;
+}
+
+static void* arena_seglist_segment(ArenaSegList* self, size_t index, size_t* length) {
+    if (!self || index >= self->segment_count) {
+        if (length) {
+            *length = 0;
+        }
+        return NULL;
+    }
+
+    size_t start = (((size_t)1 << index) - 1) << self->first_shift;
+    size_t capacity = (size_t)1 << (self->first_shift + index);
+    size_t used = self->count > start ? self->count - start : 0;
+
+    if (length) {
+        *length = used < capacity ? used : capacity;
+    }
+
+    return self->segments[index];
+}
+
+static void arena_seglist_clear(ArenaSegList* self) {
+    if (!self) {
+        return;
+    }
+
+    self->count = 0;
+}
+
+#define ARENA_POOL_ALIGNMENT (2 * sizeof(void*))
+
+static inline void arena_spin_lock(volatile int* lock) {
+#if defined(_MSC_VER)
+    while (_InterlockedExchange((volatile long*)lock, 1)) {
+        while (*lock) {
+        }
+    }
+#else
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+        }
+    }
+#endif
+}
+
+static inline void arena_spin_unlock(volatile int* lock) {
+#if defined(_MSC_VER)
+    _InterlockedExchange((volatile long*)lock, 0);
+#else
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline void* arena_atomic_load_ptr(void* volatile* target) {
+#if defined(_MSC_VER)
+    return *target;
+#else
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline bool arena_atomic_cas_ptr(void* volatile* target, void* expected, void* desired) {
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchangePointer(target, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(target, &expected, desired, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void* arena_atomic_exchange_ptr(void* volatile* target, void* value) {
+#if defined(_MSC_VER)
+    return _InterlockedExchangePointer(target, value);
+#else
+    return __atomic_exchange_n(target, value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void* arena_pool_alloc(ArenaPool* self);
+static void arena_pool_free(ArenaPool* self, void* ptr);
+static void arena_pool_remote_free(ArenaPool* self, void* ptr);
+static void arena_pool_cache_init(ArenaPool* self, ArenaPoolCache* cache, size_t capacity);
+static void* arena_pool_cache_alloc(ArenaPool* self, ArenaPoolCache* cache);
+static void arena_pool_cache_free(ArenaPool* self, ArenaPoolCache* cache, void* ptr);
+static void arena_pool_cache_flush(ArenaPool* self, ArenaPoolCache* cache);
+static void arena_pool_print_stats(ArenaPool* self);
+
+ArenaPool* ArenaPool_create(Arena* arena, size_t object_size, size_t batch_count) {
+    if (!arena || object_size == 0 || batch_count == 0) {
+        return NULL;
+    }
+
+    ArenaPool* self = (ArenaPool*)arena->alloc_aligned(arena->self, sizeof(ArenaPool), sizeof(void*));
+    if (!self) {
+        return NULL;
+    }
+
+    if (object_size < sizeof(void*)) {
+        object_size = sizeof(void*);
+    }
+
+    self->self = self;
+    self->arena = arena;
+    self->object_size = align_forward(object_size, ARENA_POOL_ALIGNMENT);
+    self->batch_count = batch_count;
+    self->free_list = NULL;
+    self->batch = NULL;
+    self->batch_remaining = 0;
+    self->batches = 0;
+    self->slot_count = 0;
+    self->free_count = 0;
+    self->locked = false;
+    self->lock = 0;
+    self->remote_free_list = NULL;
+    self->remote_drained = 0;
+    self->alloc = arena_pool_alloc;
+    self->free = arena_pool_free;
+    self->remote_free = arena_pool_remote_free;
+    self->cache_init = arena_pool_cache_init;
+    self->cache_alloc = arena_pool_cache_alloc;
+    self->cache_free = arena_pool_cache_free;
+    self->cache_flush = arena_pool_cache_flush;
+    self->print_stats = arena_pool_print_stats;
+
+    return self;
+}
+
+static void arena_pool_drain_remote(ArenaPool* self) {
+    void* list = arena_atomic_exchange_ptr(&self->remote_free_list, NULL);
+    if (!list) {
+        return;
+    }
+
+    void* tail = list;
+    size_t count = 1;
+    while (*(void**)tail) {
+        tail = *(void**)tail;
+        count++;
+    }
+    *(void**)tail = self->free_list;
+    self->free_list = list;
+    self->free_count += count;
+    self->remote_drained += count;
+}
+
+static void* arena_pool_take(ArenaPool* self) {
+    if (!self->free_list && arena_atomic_load_ptr(&self->remote_free_list)) {
+        arena_pool_drain_remote(self);
+    }
+
+    void* ptr = self->free_list;
+    if (ptr) {
+        self->free_list = *(void**)ptr;
+        self->free_count--;
+        return ptr;
+    }
+
+    if (self->batch_remaining == 0) {
+        uint8_t* batch = (uint8_t*)self->arena->alloc_aligned(self->arena->self,
+                                                              self->object_size * self->batch_count,
+                                                              ARENA_POOL_ALIGNMENT);
+        if (!batch) {
+            return NULL;
+        }
+        self->batch = batch;
+        self->batch_remaining = self->batch_count;
+        self->batches++;
+    }
+
+    ptr = self->batch;
+    self->batch += self->object_size;
+    self->batch_remaining--;
+    self->slot_count++;
+
+    return ptr;
+}
+
+static void arena_pool_give(ArenaPool* self, void* ptr) {
+    *(void**)ptr = self->free_list;
+    self->free_list = ptr;
+    self->free_count++;
+}
+
+static void* arena_pool_alloc(ArenaPool* self) {
+    if (!self) {
+        return NULL;
+    }
+
+    if (!self->locked) {
+        return arena_pool_take(self);
+    }
+
+    arena_spin_lock(&self->lock);
+    void* ptr = arena_pool_take(self);
+    arena_spin_unlock(&self->lock);
+
+    return ptr;
+}
+
+static void arena_pool_free(ArenaPool* self, void* ptr) {
+    if (!self || !ptr) {
+        return;
+    }
+
+    if (!self->locked) {
+        arena_pool_give(self, ptr);
+        return;
+    }
+
+    arena_spin_lock(&self->lock);
+    arena_pool_give(self, ptr);
+    arena_spin_unlock(&self->lock);
+}
+
+static void arena_pool_remote_free(ArenaPool* self, void* ptr) {
+    if (!self || !ptr) {
+        return;
+    }
+
+    void* head;
+    do {
+        head = arena_atomic_load_ptr(&self->remote_free_list);
+        *(void**)ptr = head;
+    } while (!arena_atomic_cas_ptr(&self->remote_free_list, head, ptr));
+}
+
+static void arena_pool_cache_init(ArenaPool* self, ArenaPoolCache* cache, size_t capacity) {
+    if (!self || !cache) {
+        return;
+    }
+
+    cache->pool = self;
+    cache->free_list = NULL;
+    cache->count = 0;
+    cache->capacity = capacity < 2 ? 2 : capacity;
+    if (!self->locked) {
+        self->locked = true;
+    }
+}
+
+static void* arena_pool_cache_alloc(ArenaPool* self, ArenaPoolCache* cache) {
+    if (!self || !cache) {
+        return NULL;
+    }
+
+    void* ptr = cache->free_list;
+    if (ptr) {
+        cache->free_list = *(void**)ptr;
+        cache->count--;
+        return ptr;
+    }
+
+    size_t refill = cache->capacity / 2;
+    arena_spin_lock(&self->lock);
+    ptr = arena_pool_take(self);
+    while (ptr && cache->count < refill) {
+        void* extra = arena_pool_take(self);
+        if (!extra) {
+            break;
+        }
+        *(void**)extra = cache->free_list;
+        cache->free_list = extra;
+        cache->count++;
+    }
+    arena_spin_unlock(&self->lock);
+
+    return ptr;
+}
+
+static void arena_pool_cache_free(ArenaPool* self, ArenaPoolCache* cache, void* ptr) {
+    if (!self || !cache || !ptr) {
+        return;
+    }
+
+    *(void**)ptr = cache->free_list;
+    cache->free_list = ptr;
+    cache->count++;
+
+    if (cache->count < cache->capacity) {
+        return;
+    }
+
+    size_t keep = cache->capacity / 2;
+    arena_spin_lock(&self->lock);
+    while (cache->count > keep) {
+        void* object = cache->free_list;
+        cache->free_list = *(void**)object;
+        cache->count--;
+        arena_pool_give(self, object);
+    }
+    arena_spin_unlock(&self->lock);
+}
+
+static void arena_pool_cache_flush(ArenaPool* self, ArenaPoolCache* cache) {
+    if (!self || !cache || !cache->free_list) {
+        return;
+    }
+
+    arena_spin_lock(&self->lock);
+    while (cache->free_list) {
+        void* object = cache->free_list;
+        cache->free_list = *(void**)object;
+        arena_pool_give(self, object);
+    }
+    arena_spin_unlock(&self->lock);
+    cache->count = 0;
+}
+
+static void arena_pool_print_stats(ArenaPool* self) {
+    if (!self) {
+        return;
+    }
+
+    printf("\n=== Arena Pool Statistics ===\n");
+    printf("  Object Size: %zu bytes\n", self->object_size);
+    printf("  Batches: %zu (%zu objects each)\n", self->batches, self->batch_count);
+    printf("  Slots Carved: %zu\n", self->slot_count);
+    printf("  Free In Pool: %zu\n", self->free_count);
+    printf("  In Use Or Cached: %zu\n", self->slot_count - self->free_count);
+    printf("  Uncarved In Batch: %zu\n", self->batch_remaining);
+    printf("  Remote Frees Reclaimed: %zu\n", self->remote_drained);
+    printf("=============================\n\n");
+}
+
+static const uint16_t arena_slab_class_sizes[ARENA_SLAB_CLASS_COUNT] = {
+    16,  32,  48,  64,  80,   96,   112,  128,  160,  192,  224,  256,
+    320, 384, 448, 512, 640,  768,  896,  1024, 1280, 1536, 1792, 2048,
+};
+
+static inline size_t arena_slab_class_index(size_t size) {
+    if (size <= 128) {
+        return size == 0 ? 0 : (size - 1) >> 4;
+    }
+    size_t shift = 63 - arena_clz64(size - 1);
+    return 8 + (shift - 7) * 4 + ((size - 1) >> (shift - 2)) - 4;
+}
+
+static void* arena_slab_alloc(ArenaSlab* self, size_t size);
+static void arena_slab_free(ArenaSlab* self, void* ptr, size_t size);
+static void arena_slab_remote_free(ArenaSlab* self, void* ptr, size_t size);
+static void* arena_slab_realloc(ArenaSlab* self, void* ptr, size_t old_size, size_t new_size);
+static void arena_slab_print_stats(ArenaSlab* self);
+
+ArenaSlab* ArenaSlab_create(Arena* arena, size_t slab_size) {
+    if (!arena) {
+        return NULL;
+    }
+
+    if (slab_size < ARENA_SLAB_MAX_SIZE) {
+        slab_size = 16 * 1024;
+    }
+
+    ArenaSlab* self = (ArenaSlab*)arena->alloc_aligned(arena->self, sizeof(ArenaSlab), sizeof(void*));
+    if (!self) {
+        return NULL;
+    }
+
+    self->self = self;
+    self->arena = arena;
+    self->slab_size = slab_size;
+    for (size_t i = 0; i < ARENA_SLAB_CLASS_COUNT; i++) {
+        self->classes[i] = NULL;
+    }
+    self->large_count = 0;
+    self->large_bytes = 0;
+    self->alloc = arena_slab_alloc;
+    self->free = arena_slab_free;
+    self->remote_free = arena_slab_remote_free;
+    self->realloc = arena_slab_realloc;
+    self->print_stats = arena_slab_print_stats;
+
+    return self;
+}
+
+static void* arena_slab_alloc(ArenaSlab* self, size_t size) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    if (size > ARENA_SLAB_MAX_SIZE) {
+        void* ptr = self->arena->alloc_aligned(self->arena->self, size, ARENA_POOL_ALIGNMENT);
+        if (ptr) {
+            self->large_count++;
+            self->large_bytes += size;
+        }
+        return ptr;
+    }
+
+    size_t index = arena_slab_class_index(size);
+    ArenaPool* pool = self->classes[index];
+    if (!pool) {
+        size_t object_size = arena_slab_class_sizes[index];
+        pool = ArenaPool_create(self->arena, object_size, self->slab_size / object_size);
+        if (!pool) {
+            return NULL;
+        }
+        self->classes[index] = pool;
+    }
+
+    return pool->alloc(pool->self);
+}
+
+static void arena_slab_free(ArenaSlab* self, void* ptr, size_t size) {
+    if (!self || !ptr || size == 0) {
+        return;
+    }
+
+    if (size > ARENA_SLAB_MAX_SIZE) {
+        if (self->arena->free_last(self->arena->self, ptr, size)) {
+            self->large_count--;
+            self->large_bytes -= size;
+        }
+        return;
+    }
+
+    ArenaPool* pool = self->classes[arena_slab_class_index(size)];
+    if (pool) {
+        pool->free(pool->self, ptr);
+    }
+}
+
+static void arena_slab_remote_free(ArenaSlab* self, void* ptr, size_t size) {
+    if (!self || !ptr || size == 0 || size > ARENA_SLAB_MAX_SIZE) {
+        return;
+    }
+
+    ArenaPool* pool = self->classes[arena_slab_class_index(size)];
+    if (pool) {
+        pool->remote_free(pool->self, ptr);
+    }
+}
+
+static void* arena_slab_realloc(ArenaSlab* self, void* ptr, size_t old_size, size_t new_size) {
+    if (!self) {
+        return NULL;
+    }
+
+    if (ptr == NULL) {
+        return arena_slab_alloc(self, new_size);
+    }
+
+    if (new_size == 0) {
+        arena_slab_free(self, ptr, old_size);
+        return NULL;
+    }
+
+    if (old_size <= ARENA_SLAB_MAX_SIZE && new_size <= ARENA_SLAB_MAX_SIZE &&
+        arena_slab_class_index(old_size) == arena_slab_class_index(new_size)) {
+        return ptr;
+    }
+
+    void* new_ptr = arena_slab_alloc(self, new_size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+        arena_slab_free(self, ptr, old_size);
+    }
+
+    return new_ptr;
+}
+
+static void arena_slab_print_stats(ArenaSlab* self) {
+    if (!self) {
+        return;
+    }
+
+    printf("\n=== Arena Slab Statistics ===\n");
+    for (size_t i = 0; i < ARENA_SLAB_CLASS_COUNT; i++) {
+        ArenaPool* pool = self->classes[i];
+        if (!pool) {
+            continue;
+        }
+        printf("  Class %4u: %zu slabs, %zu slots, %zu free\n",
+               arena_slab_class_sizes[i], pool->batches, pool->slot_count, pool->free_count);
+    }
+    printf("  Large: %zu allocations, %zu bytes\n", self->large_count, self->large_bytes);
+    printf("=============================\n\n");
+}
+
+#define ARENA_TLSF_ALIGNMENT (2 * sizeof(void*))
+#define ARENA_TLSF_HEADER (2 * sizeof(void*))
+#define ARENA_TLSF_MIN_PAYLOAD (2 * sizeof(void*))
+#define ARENA_TLSF_FREE ((size_t)1)
+#define ARENA_TLSF_PREV_FREE ((size_t)2)
+#define ARENA_TLSF_FLAGS (ARENA_TLSF_FREE | ARENA_TLSF_PREV_FREE)
+#define ARENA_TLSF_FL_SHIFT (ARENA_TLSF_SL_LOG2 + (sizeof(void*) == 8 ? 4 : 3))
+#define ARENA_TLSF_SMALL_BLOCK ((size_t)1 << ARENA_TLSF_FL_SHIFT)
+#define ARENA_TLSF_MAX_BLOCK                                                                  \
+    (sizeof(size_t) == 8 ? (size_t)((1ULL << (ARENA_TLSF_FL_COUNT + ARENA_TLSF_FL_SHIFT - 1)) - 1) \
+                         : (SIZE_MAX >> 1))
+
+static void* arena_tlsf_alloc(ArenaTlsf* self, size_t size);
+static void arena_tlsf_free(ArenaTlsf* self, void* ptr);
+static void* arena_tlsf_realloc(ArenaTlsf* self, void* ptr, size_t new_size);
+static void arena_tlsf_print_stats(ArenaTlsf* self);
+
+static inline size_t arena_tlsf_block_size(const ArenaTlsfBlock* block) {
+    return block->size & ~ARENA_TLSF_FLAGS;
+}
+
+static inline void* arena_tlsf_payload(ArenaTlsfBlock* block) {
+    return (uint8_t*)block + ARENA_TLSF_HEADER;
+}
+
+static inline ArenaTlsfBlock* arena_tlsf_from_payload(void* ptr) {
+    return (ArenaTlsfBlock*)((uint8_t*)ptr - ARENA_TLSF_HEADER);
+}
+
+static inline ArenaTlsfBlock* arena_tlsf_next_phys(ArenaTlsfBlock* block) {
+    return (ArenaTlsfBlock*)((uint8_t*)arena_tlsf_payload(block) + arena_tlsf_block_size(block));
+}
+
+static inline void arena_tlsf_mapping(size_t size, size_t* fl, size_t* sl) {
+    if (size < ARENA_TLSF_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = size / (ARENA_TLSF_SMALL_BLOCK / ARENA_TLSF_SL_COUNT);
+        return;
+    }
+    size_t top_bit = 63 - arena_clz64(size);
+    *sl = (size >> (top_bit - ARENA_TLSF_SL_LOG2)) ^ ((size_t)1 << ARENA_TLSF_SL_LOG2);
+    *fl = top_bit - (ARENA_TLSF_FL_SHIFT - 1);
+}
+
+static inline void arena_tlsf_mapping_search(size_t size, size_t* fl, size_t* sl) {
+    if (size >= ARENA_TLSF_SMALL_BLOCK) {
+        size += ((size_t)1 << (63 - arena_clz64(size) - ARENA_TLSF_SL_LOG2)) - 1;
+    }
+    arena_tlsf_mapping(size, fl, sl);
+}
+
+static void arena_tlsf_insert(ArenaTlsf* self, ArenaTlsfBlock* block) {
+    size_t fl, sl;
+    arena_tlsf_mapping(arena_tlsf_block_size(block), &fl, &sl);
+
+    ArenaTlsfBlock* head = self->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) {
+        head->prev_free = block;
+    }
+    self->blocks[fl][sl] = block;
+    self->fl_bitmap |= 1u << fl;
+    self->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void arena_tlsf_remove(ArenaTlsf* self, ArenaTlsfBlock* block) {
+    size_t fl, sl;
+    arena_tlsf_mapping(arena_tlsf_block_size(block), &fl, &sl);
+
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        self->blocks[fl][sl] = block->next_free;
+        if (!block->next_free) {
+            self->sl_bitmap[fl] &= ~(1u << sl);
+            if (!self->sl_bitmap[fl]) {
+                self->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+}
+
+static ArenaTlsfBlock* arena_tlsf_find(ArenaTlsf* self, size_t size) {
+    size_t fl, sl;
+    arena_tlsf_mapping_search(size, &fl, &sl);
+    if (fl >= ARENA_TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = self->sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t fl_map = fl + 1 < ARENA_TLSF_FL_COUNT ? self->fl_bitmap & (~0u << (fl + 1)) : 0;
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = arena_ctz32(fl_map);
+        sl_map = self->sl_bitmap[fl];
+    }
+
+    return self->blocks[fl][arena_ctz32(sl_map)];
+}
+
+static bool arena_tlsf_add_pool(ArenaTlsf* self, size_t size) {
+    size = align_forward(size, ARENA_TLSF_ALIGNMENT) + 2 * ARENA_TLSF_HEADER;
+    uint8_t* memory = (uint8_t*)self->arena->alloc_aligned(self->arena->self, size, ARENA_TLSF_ALIGNMENT);
+    if (!memory) {
+        return false;
+    }
+
+    ArenaTlsfBlock* block = (ArenaTlsfBlock*)memory;
+    block->prev_phys = NULL;
+    block->size = (size - 2 * ARENA_TLSF_HEADER) | ARENA_TLSF_FREE;
+
+    ArenaTlsfBlock* sentinel = arena_tlsf_next_phys(block);
+    sentinel->prev_phys = block;
+    sentinel->size = ARENA_TLSF_PREV_FREE;
+
+    arena_tlsf_insert(self, block);
+    self->pool_count++;
+
+    return true;
+}
+
+static void arena_tlsf_split(ArenaTlsf* self, ArenaTlsfBlock* block, size_t size) {
+    size_t block_size = arena_tlsf_block_size(block);
+    if (block_size < size + ARENA_TLSF_HEADER + ARENA_TLSF_MIN_PAYLOAD) {
+        return;
+    }
+
+    ArenaTlsfBlock* rest = (ArenaTlsfBlock*)((uint8_t*)arena_tlsf_payload(block) + size);
+    rest->prev_phys = block;
+    rest->size = (block_size - size - ARENA_TLSF_HEADER) | ARENA_TLSF_FREE;
+    block->size = size | (block->size & ARENA_TLSF_FLAGS);
+
+    ArenaTlsfBlock* next = arena_tlsf_next_phys(rest);
+    next->prev_phys = rest;
+    if (next->size & ARENA_TLSF_FREE) {
+        arena_tlsf_remove(self, next);
+        rest->size += ARENA_TLSF_HEADER + arena_tlsf_block_size(next);
+        arena_tlsf_next_phys(rest)->prev_phys = rest;
+    } else {
+        next->size |= ARENA_TLSF_PREV_FREE;
+    }
+
+    arena_tlsf_insert(self, rest);
+}
+
+ArenaTlsf* ArenaTlsf_create(Arena* arena, size_t pool_size) {
+    if (!arena || pool_size == 0) {
+        return NULL;
+    }
+
+    ArenaTlsf* self = (ArenaTlsf*)arena->alloc_aligned(arena->self, sizeof(ArenaTlsf), sizeof(void*));
+    if (!self) {
+        return NULL;
+    }
+
+    memset(self, 0, sizeof(ArenaTlsf));
+    self->self = self;
+    self->arena = arena;
+    self->pool_size = pool_size;
+    self->alloc = arena_tlsf_alloc;
+    self->free = arena_tlsf_free;
+    self->realloc = arena_tlsf_realloc;
+    self->print_stats = arena_tlsf_print_stats;
+
+    if (!arena_tlsf_add_pool(self, pool_size)) {
+        return NULL;
+    }
+
+    return self;
+}
+
+static void* arena_tlsf_alloc(ArenaTlsf* self, size_t size) {
+    if (!self || size == 0 || size > ARENA_TLSF_MAX_BLOCK) {
+        return NULL;
+    }
+
+    size = align_forward(size < ARENA_TLSF_MIN_PAYLOAD ? ARENA_TLSF_MIN_PAYLOAD : size, ARENA_TLSF_ALIGNMENT);
+
+    ArenaTlsfBlock* block = arena_tlsf_find(self, size);
+    if (!block) {
+        size_t grow = self->pool_size;
+        size_t needed = size;
+        if (size >= ARENA_TLSF_SMALL_BLOCK) {
+            needed += (size_t)1 << (63 - arena_clz64(size) - ARENA_TLSF_SL_LOG2);
+        }
+        if (grow < needed) {
+            grow = needed;
+        }
+        if (!arena_tlsf_add_pool(self, grow)) {
+            return NULL;
+        }
+        block = arena_tlsf_find(self, size);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    arena_tlsf_remove(self, block);
+    block->size &= ~ARENA_TLSF_FREE;
+    ArenaTlsfBlock* next = arena_tlsf_next_phys(block);
+    next->size &= ~ARENA_TLSF_PREV_FREE;
+    arena_tlsf_split(self, block, size);
+
+    self->used_bytes += arena_tlsf_block_size(block);
+    if (self->used_bytes > self->peak_bytes) {
+        self->peak_bytes = self->used_bytes;
+    }
+
+    return arena_tlsf_payload(block);
+}
+
+static void arena_tlsf_free(ArenaTlsf* self, void* ptr) {
+    if (!self || !ptr) {
+        return;
+    }
+
+    ArenaTlsfBlock* block = arena_tlsf_from_payload(ptr);
+    self->used_bytes -= arena_tlsf_block_size(block);
+
+    if (block->size & ARENA_TLSF_PREV_FREE) {
+        ArenaTlsfBlock* prev = block->prev_phys;
+        arena_tlsf_remove(self, prev);
+        prev->size += ARENA_TLSF_HEADER + arena_tlsf_block_size(block);
+        block = prev;
+    }
+
+    ArenaTlsfBlock* next = arena_tlsf_next_phys(block);
+    if (next->size & ARENA_TLSF_FREE) {
+        arena_tlsf_remove(self, next);
+        block->size += ARENA_TLSF_HEADER + arena_tlsf_block_size(next);
+        next = arena_tlsf_next_phys(block);
+    }
+
+    block->size |= ARENA_TLSF_FREE;
+    next->prev_phys = block;
+    next->size |= ARENA_TLSF_PREV_FREE;
+    arena_tlsf_insert(self, block);
+}
+
+static void* arena_tlsf_realloc(ArenaTlsf* self, void* ptr, size_t new_size) {
+    if (!self) {
+        return NULL;
+    }
+
+    if (ptr == NULL) {
+        return arena_tlsf_alloc(self, new_size);
+    }
+
+    if (new_size == 0) {
+        arena_tlsf_free(self, ptr);
+        return NULL;
+    }
+
+    if (new_size > ARENA_TLSF_MAX_BLOCK) {
+        return NULL;
+    }
+
+    ArenaTlsfBlock* block = arena_tlsf_from_payload(ptr);
+    size_t current = arena_tlsf_block_size(block);
+    size_t size = align_forward(new_size < ARENA_TLSF_MIN_PAYLOAD ? ARENA_TLSF_MIN_PAYLOAD : new_size,
+                                ARENA_TLSF_ALIGNMENT);
+
+    if (size > current) {
+        ArenaTlsfBlock* next = arena_tlsf_next_phys(block);
+        size_t combined = current + ARENA_TLSF_HEADER + arena_tlsf_block_size(next);
+        if (!(next->size & ARENA_TLSF_FREE) || combined < size) {
+            void* new_ptr = arena_tlsf_alloc(self, new_size);
+            if (new_ptr) {
+                memcpy(new_ptr, ptr, current);
+                arena_tlsf_free(self, ptr);
+            }
+            return new_ptr;
+        }
+        arena_tlsf_remove(self, next);
+        block->size += ARENA_TLSF_HEADER + arena_tlsf_block_size(next);
+        next = arena_tlsf_next_phys(block);
+        next->prev_phys = block;
+        next->size &= ~ARENA_TLSF_PREV_FREE;
+    }
+
+    arena_tlsf_split(self, block, size);
+    self->used_bytes = self->used_bytes - current + arena_tlsf_block_size(block);
+    if (self->used_bytes > self->peak_bytes) {
+        self->peak_bytes = self->used_bytes;
+    }
+
+    return ptr;
+}
+
+static void arena_tlsf_print_stats(ArenaTlsf* self) {
+    if (!self) {
+        return;
+    }
+
+    size_t free_blocks = 0;
+    size_t free_bytes = 0;
+    size_t largest_free = 0;
+    for (size_t fl = 0; fl < ARENA_TLSF_FL_COUNT; fl++) {
+        for (size_t sl = 0; sl < ARENA_TLSF_SL_COUNT; sl++) {
+            for (ArenaTlsfBlock* block = self->blocks[fl][sl]; block; block = block->next_free) {
+                size_t size = arena_tlsf_block_size(block);
+                free_blocks++;
+                free_bytes += size;
+                if (size > largest_free) {
+                    largest_free = size;
+                }
+            }
+        }
+    }
+
+    printf("\n=== Arena TLSF Statistics ===\n");
+    printf("  Pools: %zu (%zu bytes each)\n", self->pool_count, self->pool_size);
+    printf("  Used: %zu bytes\n", self->used_bytes);
+    printf("  Peak: %zu bytes\n", self->peak_bytes);
+    printf("  Free: %zu bytes in %zu blocks\n", free_bytes, free_blocks);
+    printf("  Largest Free Block: %zu bytes\n", largest_free);
+    printf("=============================\n\n");
+}
+
+static void* arena_buddy_alloc(ArenaBuddy* self, size_t size);
+static void arena_buddy_free(ArenaBuddy* self, void* ptr);
+static void arena_buddy_print_stats(ArenaBuddy* self);
+
+static inline size_t arena_buddy_bit(ArenaBuddy* self, size_t index, size_t order) {
+    return self->level_offset[order] + (index >> order);
+}
+
+static inline bool arena_buddy_is_free(ArenaBuddy* self, size_t index, size_t order) {
+    size_t bit = arena_buddy_bit(self, index, order);
+    return (self->free_bits[bit / 64] >> (bit % 64)) & 1;
+}
+
+static void arena_buddy_push(ArenaBuddy* self, size_t index, size_t order) {
+    ArenaBuddyNode* node = (ArenaBuddyNode*)(self->memory + (index << self->min_shift));
+    node->prev = NULL;
+    node->next = self->free_lists[order];
+    if (node->next) {
+        node->next->prev = node;
+    }
+    self->free_lists[order] = node;
+    self->nonempty |= 1u << order;
+
+    size_t bit = arena_buddy_bit(self, index, order);
+    self->free_bits[bit / 64] |= (uint64_t)1 << (bit % 64);
+}
+
+static void arena_buddy_unlink(ArenaBuddy* self, size_t index, size_t order) {
+    ArenaBuddyNode* node = (ArenaBuddyNode*)(self->memory + (index << self->min_shift));
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        self->free_lists[order] = node->next;
+        if (!node->next) {
+            self->nonempty &= ~(1u << order);
+        }
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
 
-        current = current->next;
+    size_t bit = arena_buddy_bit(self, index, order);
+    self->free_bits[bit / 64] &= ~((uint64_t)1 << (bit % 64));
+}
+
+ArenaBuddy* ArenaBuddy_create(Arena* arena, size_t min_block, size_t max_block) {
+    if (!arena) {
+        return NULL;
     }
 
-    printf("\nTotal Summary:\n");
-    printf("  Chunks: %zu\n", chunk_count);
-    printf("  Total Size: %zu bytes\n", total_size);
-    printf("  Total Used: %zu bytes (%.2f%%)\n",
-           total_used,
-           total_size > 0 ? (total_used * 100.0) / total_size : 0.0);
-    printf("  Total Allocations: %zu\n", total_allocations);
-    printf("========================\n\n");
+    if (!is_power_of_two(min_block) || !is_power_of_two(max_block) ||
+        min_block < sizeof(ArenaBuddyNode) || max_block < min_block) {
+        fprintf(stderr, "Arena: Buddy block sizes must be powers of 2 with min <= max\n");
+        return NULL;
+    }
+
+    size_t min_shift = 63 - arena_clz64(min_block);
+    size_t max_order = (63 - arena_clz64(max_block)) - min_shift;
+    if (max_order >= ARENA_BUDDY_MAX_ORDERS) {
+        fprintf(stderr, "Arena: Too many buddy orders\n");
+        return NULL;
+    }
+
+    size_t leaf_count = (size_t)1 << max_order;
+    size_t bit_words = (2 * leaf_count + 63) / 64;
+    size_t bytes = sizeof(ArenaBuddy) + bit_words * sizeof(uint64_t) + leaf_count;
+
+    ArenaBuddy* self = (ArenaBuddy*)arena->alloc_aligned(arena->self, bytes, sizeof(uint64_t));
+    if (!self) {
+        return NULL;
+    }
+
+    uint8_t* memory = (uint8_t*)arena->alloc_aligned(arena->self, max_block, max_block);
+    if (!memory) {
+        return NULL;
+    }
+
+    memset(self, 0, bytes);
+    self->self = self;
+    self->arena = arena;
+    self->memory = memory;
+    self->min_block = min_block;
+    self->max_block = max_block;
+    self->min_shift = min_shift;
+    self->max_order = max_order;
+    self->free_bits = (uint64_t*)(self + 1);
+    self->orders = (uint8_t*)(self->free_bits + bit_words);
+    self->alloc = arena_buddy_alloc;
+    self->free = arena_buddy_free;
+    self->print_stats = arena_buddy_print_stats;
+
+    size_t offset = 0;
+    for (size_t order = 0; order <= max_order; order++) {
+        self->level_offset[order] = offset;
+        offset += leaf_count >> order;
+    }
+
+    arena_buddy_push(self, 0, max_order);
+
+    return self;
 }
 
-static void arena_destroy(Arena* self) {
+static void* arena_buddy_alloc(ArenaBuddy* self, size_t size) {
+    if (!self || size == 0 || size > self->max_block) {
+        return NULL;
+    }
+
+    size_t order = 0;
+    if (size > self->min_block) {
+        order = (64 - arena_clz64(size - 1)) - self->min_shift;
+    }
+
+    uint32_t candidates = self->nonempty & (~0u << order);
+    if (!candidates) {
+        return NULL;
+    }
+
+    size_t found = arena_ctz32(candidates);
+    ArenaBuddyNode* node = self->free_lists[found];
+    size_t index = (size_t)((uint8_t*)node - self->memory) >> self->min_shift;
+    arena_buddy_unlink(self, index, found);
+
+    while (found > order) {
+        found--;
+        arena_buddy_push(self, index + ((size_t)1 << found), found);
+    }
+
+    self->orders[index] = (uint8_t)order;
+    self->used_bytes += self->min_block << order;
+
+    return node;
+}
+
+static void arena_buddy_free(ArenaBuddy* self, void* ptr) {
+    if (!self || !ptr) {
+        return;
+    }
+
+    size_t index = (size_t)((uint8_t*)ptr - self->memory) >> self->min_shift;
+    size_t order = self->orders[index];
+    self->used_bytes -= self->min_block << order;
+
+    while (order < self->max_order) {
+        size_t buddy = index ^ ((size_t)1 << order);
+        if (!arena_buddy_is_free(self, buddy, order)) {
+            break;
+        }
+        arena_buddy_unlink(self, buddy, order);
+        index &= ~((size_t)1 << order);
+        order++;
+    }
+
+    arena_buddy_push(self, index, order);
+}
+
+static void arena_buddy_print_stats(ArenaBuddy* self) {
     if (!self) {
         return;
     }
 
-    Arena* head = self->head;
-    Arena* current = head;
-    while (current != NULL) {
-        Arena* next = current->next;
-        free(current->memory);
-        free(current);
-        current = next;
+    printf("\n=== Arena Buddy Statistics ===\n");
+    printf("  Region: %zu bytes (blocks %zu..%zu)\n", self->max_block, self->min_block, self->max_block);
+    printf("  Used: %zu bytes\n", self->used_bytes);
+    for (size_t order = 0; order <= self->max_order; order++) {
+        size_t count = 0;
+        for (ArenaBuddyNode* node = self->free_lists[order]; node; node = node->next) {
+            count++;
+        }
+        if (count > 0) {
+            printf("  Free %zu-byte blocks: %zu\n", self->min_block << order, count);
+        }
+    }
+    printf("==============================\n\n");
+}
+
+static inline uint64_t arena_atomic_load_u64(volatile uint64_t* target) {
+#if defined(_MSC_VER)
+    return *target;
+#else
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void arena_atomic_store_u64(volatile uint64_t* target, uint64_t value) {
+#if defined(_MSC_VER)
+    *target = value;
+#else
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline bool arena_atomic_cas_u64(volatile uint64_t* target, uint64_t* expected, uint64_t desired) {
+#if defined(_MSC_VER)
+    uint64_t seen = (uint64_t)_InterlockedCompareExchange64((volatile long long*)target, (long long)desired,
+                                                            (long long)*expected);
+    if (seen == *expected) {
+        return true;
+    }
+    *expected = seen;
+    return false;
+#else
+    return __atomic_compare_exchange_n(target, expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline uint64_t arena_atomic_add_u64(volatile uint64_t* target, uint64_t value) {
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedExchangeAdd64((volatile long long*)target, (long long)value);
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+static inline void arena_yield(void) {
+#if defined(__unix__) || defined(__APPLE__)
+    sched_yield();
+#endif
+}
+
+static Arena* arena_frame_ring_begin_frame(ArenaFrameRing* self);
+static void arena_frame_ring_set_fence(ArenaFrameRing* self, ArenaFrameFence fence, void* user);
+static void arena_frame_ring_retire(ArenaFrameRing* self, uint64_t frame);
+static bool arena_frame_ring_is_retired(ArenaFrameRing* self, uint64_t frame);
+static void arena_frame_ring_destroy(ArenaFrameRing* self);
+
+ArenaFrameRing* ArenaFrameRing_create(size_t frame_count, size_t arena_size) {
+    if (frame_count == 0 || frame_count > ARENA_FRAME_RING_MAX) {
+        fprintf(stderr, "Arena: Frame ring needs 1 to %d frames\n", ARENA_FRAME_RING_MAX);
+        return NULL;
+    }
+
+    ArenaFrameRing* self = (ArenaFrameRing*)malloc(sizeof(ArenaFrameRing));
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to allocate frame ring\n");
+        return NULL;
+    }
+
+    memset(self, 0, sizeof(ArenaFrameRing));
+    for (size_t i = 0; i < frame_count; i++) {
+        self->arenas[i] = Arena_create(arena_size);
+        if (!self->arenas[i]) {
+            arena_frame_ring_destroy(self);
+            return NULL;
+        }
+        self->frames[i] = UINT64_MAX;
+    }
+
+    self->self = self;
+    self->count = frame_count;
+    self->frame = UINT64_MAX;
+    self->begin_frame = arena_frame_ring_begin_frame;
+    self->set_fence = arena_frame_ring_set_fence;
+    self->retire = arena_frame_ring_retire;
+    self->is_retired = arena_frame_ring_is_retired;
+    self->destroy = arena_frame_ring_destroy;
+
+    return self;
+}
+
+static Arena* arena_frame_ring_begin_frame(ArenaFrameRing* self) {
+    if (!self) {
+        return NULL;
+    }
+
+    uint64_t frame = self->frame + 1;
+    size_t slot = (size_t)(frame % self->count);
+
+    if (self->frames[slot] != UINT64_MAX) {
+        bool waited = false;
+        while (!arena_frame_ring_is_retired(self, self->frames[slot])) {
+            ArenaFrameFence fence = self->fences[slot];
+            if (fence && fence(self->fence_users[slot], self->frames[slot])) {
+                arena_frame_ring_retire(self, self->frames[slot]);
+                break;
+            }
+            waited = true;
+            arena_yield();
+        }
+        if (waited) {
+            self->waits++;
+        }
+    }
+
+    Arena* arena = self->arenas[slot];
+    arena->reset(arena->self);
+    self->frames[slot] = frame;
+    self->fences[slot] = NULL;
+    self->fence_users[slot] = NULL;
+    self->frame = frame;
+
+    return arena;
+}
+
+static void arena_frame_ring_set_fence(ArenaFrameRing* self, ArenaFrameFence fence, void* user) {
+    if (!self || self->frame == UINT64_MAX) {
+        return;
+    }
+
+    size_t slot = (size_t)(self->frame % self->count);
+    self->fences[slot] = fence;
+    self->fence_users[slot] = user;
+}
+
+static void arena_frame_ring_retire(ArenaFrameRing* self, uint64_t frame) {
+    if (!self) {
+        return;
+    }
+
+    volatile uint64_t* retired = &self->retired[frame % self->count];
+    if (arena_atomic_load_u64(retired) < frame + 1) {
+        arena_atomic_store_u64(retired, frame + 1);
+    }
+}
+
+static bool arena_frame_ring_is_retired(ArenaFrameRing* self, uint64_t frame) {
+    if (!self) {
+        return false;
+    }
+
+    return arena_atomic_load_u64(&self->retired[frame % self->count]) > frame;
+}
+
+static void arena_frame_ring_destroy(ArenaFrameRing* self) {
+    if (!self) {
+        return;
+    }
+
+    for (size_t i = 0; i < ARENA_FRAME_RING_MAX; i++) {
+        if (self->arenas[i]) {
+            self->arenas[i]->destroy(self->arenas[i]->self);
+        }
+    }
+    free(self);
+}
+
+typedef struct ArenaSharedHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t size;
+    volatile uint64_t offset;
+    volatile uint64_t generation;
+} ArenaSharedHeader;
+
+static void* arena_shared_alloc(ArenaShared* self, size_t size);
+static void* arena_shared_alloc_aligned(ArenaShared* self, size_t size, size_t alignment);
+static ArenaSharedOffset arena_shared_to_offset(ArenaShared* self, const void* ptr);
+static void* arena_shared_from_offset(ArenaShared* self, ArenaSharedOffset offset);
+static uint64_t arena_shared_generation(ArenaShared* self);
+static void arena_shared_reset(ArenaShared* self);
+static void arena_shared_print_stats(ArenaShared* self);
+static void arena_shared_destroy(ArenaShared* self);
+
+static ArenaShared* arena_shared_map(int fd, size_t mapped) {
+#ifdef ARENA_HAS_MMAP
+    void* memory = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "Arena: Failed to map shared arena\n");
+        return NULL;
+    }
+
+    ArenaShared* self = (ArenaShared*)malloc(sizeof(ArenaShared));
+    if (!self) {
+        fprintf(stderr, "Arena: Failed to allocate shared arena struct\n");
+        munmap(memory, mapped);
+        return NULL;
+    }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)memory;
+    self->self = self;
+    self->header = header;
+    self->data = (uint8_t*)memory + arena_page_size();
+    self->size = mapped - arena_page_size();
+    self->mapped = mapped;
+    self->fd = fd;
+    self->alloc = arena_shared_alloc;
+    self->alloc_aligned = arena_shared_alloc_aligned;
+    self->to_offset = arena_shared_to_offset;
+    self->from_offset = arena_shared_from_offset;
+    self->generation = arena_shared_generation;
+    self->reset = arena_shared_reset;
+    self->print_stats = arena_shared_print_stats;
+    self->destroy = arena_shared_destroy;
+
+    return self;
+#else
+    (void)fd;
+    (void)mapped;
+    return NULL;
+#endif
+}
+
+ArenaShared* ArenaShared_create(const char* name, size_t size) {
+#ifdef ARENA_HAS_MMAP
+    if (size == 0) {
+        fprintf(stderr, "Arena: Cannot create shared arena with size 0\n");
+        return NULL;
+    }
+
+    int fd = name ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : arena_anonymous_fd();
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to create shared memory %s\n", name ? name : "(anonymous)");
+        return NULL;
+    }
+
+    size_t mapped = arena_page_size() + align_forward(size, arena_page_size());
+    if (ftruncate(fd, (off_t)mapped) != 0) {
+        fprintf(stderr, "Arena: Failed to size shared memory to %zu bytes\n", mapped);
+        close(fd);
+        if (name) {
+            shm_unlink(name);
+        }
+        return NULL;
+    }
+
+    ArenaShared* self = arena_shared_map(fd, mapped);
+    if (!self) {
+        close(fd);
+        if (name) {
+            shm_unlink(name);
+        }
+        return NULL;
+    }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)self->header;
+    memcpy(header->magic, ARENA_SHARED_MAGIC, sizeof(header->magic));
+    header->version = ARENA_SHARED_VERSION;
+    header->header_size = (uint32_t)arena_page_size();
+    header->size = self->size;
+    header->offset = 0;
+    header->generation = 0;
+
+    return self;
+#else
+    (void)name;
+    (void)size;
+    fprintf(stderr, "Arena: Shared arenas need mmap\n");
+    return NULL;
+#endif
+}
+
+ArenaShared* ArenaShared_open_fd(int fd) {
+#ifdef ARENA_HAS_MMAP
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size <= arena_page_size()) {
+        fprintf(stderr, "Arena: Descriptor %d is not a shared arena\n", fd);
+        return NULL;
+    }
+
+    ArenaShared* self = arena_shared_map(fd, (size_t)info.st_size);
+    if (!self) {
+        return NULL;
+    }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)self->header;
+    if (memcmp(header->magic, ARENA_SHARED_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != ARENA_SHARED_VERSION || header->header_size != arena_page_size() ||
+        header->size != self->size) {
+        fprintf(stderr, "Arena: Descriptor %d is not a compatible shared arena\n", fd);
+        munmap(self->header, self->mapped);
+        free(self);
+        return NULL;
+    }
+
+    return self;
+#else
+    (void)fd;
+    fprintf(stderr, "Arena: Shared arenas need mmap\n");
+    return NULL;
+#endif
+}
+
+ArenaShared* ArenaShared_open(const char* name) {
+#ifdef ARENA_HAS_MMAP
+    int fd = name ? shm_open(name, O_RDWR, 0600) : -1;
+    if (fd < 0) {
+        fprintf(stderr, "Arena: Failed to open shared memory %s\n", name ? name : "(null)");
+        return NULL;
+    }
+
+    ArenaShared* self = ArenaShared_open_fd(fd);
+    if (!self) {
+        close(fd);
+    }
+    return self;
+#else
+    (void)name;
+    fprintf(stderr, "Arena: Shared arenas need mmap\n");
+    return NULL;
+#endif
+}
+
+bool ArenaShared_unlink(const char* name) {
+#ifdef ARENA_HAS_MMAP
+    return name && shm_unlink(name) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+static void* arena_shared_alloc_aligned(ArenaShared* self, size_t size, size_t alignment) {
+    if (!self || size == 0) {
+        return NULL;
+    }
+
+    if (!is_power_of_two(alignment) || alignment > arena_page_size()) {
+        fprintf(stderr, "Arena: Shared alignment must be a power of 2 up to the page size\n");
+        return NULL;
+    }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)self->header;
+    uint64_t offset = arena_atomic_load_u64(&header->offset);
+    uint64_t start;
+    do {
+        start = align_forward((size_t)offset, alignment);
+        if (start < offset || size > self->size || start > self->size - size) {
+            return NULL;
+        }
+    } while (!arena_atomic_cas_u64(&header->offset, &offset, start + size));
+
+    return self->data + start;
+}
+
+static void* arena_shared_alloc(ArenaShared* self, size_t size) {
+    return arena_shared_alloc_aligned(self, size, 1);
+}
+
+static ArenaSharedOffset arena_shared_to_offset(ArenaShared* self, const void* ptr) {
+    if (!self || !ptr || (const uint8_t*)ptr < self->data || (const uint8_t*)ptr >= self->data + self->size) {
+        return 0;
+    }
+
+    return (ArenaSharedOffset)((const uint8_t*)ptr - (const uint8_t*)self->header);
+}
+
+static void* arena_shared_from_offset(ArenaShared* self, ArenaSharedOffset offset) {
+    if (!self || offset < (ArenaSharedOffset)(self->data - (uint8_t*)self->header) || offset >= self->mapped) {
+        return NULL;
+    }
+
+    return (uint8_t*)self->header + offset;
+}
+
+static uint64_t arena_shared_generation(ArenaShared* self) {
+    if (!self) {
+        return 0;
+    }
+
+    return arena_atomic_load_u64(&((ArenaSharedHeader*)self->header)->generation);
+}
+
+static void arena_shared_reset(ArenaShared* self) {
+    if (!self) {
+        return;
+    }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)self->header;
+    arena_atomic_add_u64(&header->generation, 1);
+    arena_atomic_store_u64(&header->offset, 0);
+}
+
+static void arena_shared_print_stats(ArenaShared* self) {
+    if (!self) {
+        return;
     }
+
+    ArenaSharedHeader* header = (ArenaSharedHeader*)self->header;
+    uint64_t used = arena_atomic_load_u64(&header->offset);
+    printf("\n=== Arena Shared Statistics ===\n");
+    printf("  Size: %zu bytes\n", self->size);
+    printf("  Used: %llu bytes (%.2f%%)\n", (unsigned long long)used, (used * 100.0) / self->size);
+    printf("  Generation: %llu\n", (unsigned long long)arena_atomic_load_u64(&header->generation));
+    printf("  Mapped At: %p (fd %d)\n", self->header, self->fd);
+    printf("===============================\n\n");
+}
+
+static void arena_shared_destroy(ArenaShared* self) {
+    if (!self) {
+        return;
+    }
+
+#ifdef ARENA_HAS_MMAP
+    munmap(self->header, self->mapped);
+    close(self->fd);
+#endif
+    free(self);
 }
 
 #endif
@@ -0,0 +1,247 @@
+#define ARENA_IMPLEMENTATION
+#include "arena.h"
+#include <time.h>
+
+#define BENCH_KEYS (1 << 20)
+#define BENCH_ROUNDS 5
+#define BENCH_BUMP_ALLOCS (1 << 22)
+
+ARENA_MAP_DEFINE(BenchMap, uint64_t, uint64_t, ARENA_MAP_HASH_INT, ARENA_MAP_EQ_INT)
+
+static double now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+typedef struct MallocNode {
+    uint64_t key;
+    uint64_t value;
+    struct MallocNode* next;
+} MallocNode;
+
+typedef struct MallocMap {
+    MallocNode** buckets;
+    size_t bucket_count;
+    size_t count;
+} MallocMap;
+
+static void malloc_map_init(MallocMap* map) {
+    map->bucket_count = 16;
+    map->count = 0;
+    map->buckets = (MallocNode**)calloc(map->bucket_count, sizeof(MallocNode*));
+}
+
+static void malloc_map_grow(MallocMap* map) {
+    size_t bucket_count = map->bucket_count * 2;
+    MallocNode** buckets = (MallocNode**)calloc(bucket_count, sizeof(MallocNode*));
+    for (size_t i = 0; i < map->bucket_count; i++) {
+        MallocNode* node = map->buckets[i];
+        while (node) {
+            MallocNode* next = node->next;
+            size_t index = arena_hash_u64(node->key) & (bucket_count - 1);
+            node->next = buckets[index];
+            buckets[index] = node;
+            node = next;
+        }
+    }
+    free(map->buckets);
+    map->buckets = buckets;
+    map->bucket_count = bucket_count;
+}
+
+static uint64_t* malloc_map_get(MallocMap* map, uint64_t key) {
+    MallocNode* node = map->buckets[arena_hash_u64(key) & (map->bucket_count - 1)];
+    while (node) {
+        if (node->key == key) {
+            return &node->value;
+        }
+        node = node->next;
+    }
+    return NULL;
+}
+
+static void malloc_map_put(MallocMap* map, uint64_t key, uint64_t value) {
+    uint64_t* existing = malloc_map_get(map, key);
+    if (existing) {
+        *existing = value;
+        return;
+    }
+    if (map->count >= map->bucket_count) {
+        malloc_map_grow(map);
+    }
+    size_t index = arena_hash_u64(key) & (map->bucket_count - 1);
+    MallocNode* node = (MallocNode*)malloc(sizeof(MallocNode));
+    node->key = key;
+    node->value = value;
+    node->next = map->buckets[index];
+    map->buckets[index] = node;
+    map->count++;
+}
+
+static void malloc_map_free(MallocMap* map) {
+    for (size_t i = 0; i < map->bucket_count; i++) {
+        MallocNode* node = map->buckets[i];
+        while (node) {
+            MallocNode* next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(map->buckets);
+}
+
+static uint64_t bench_key(uint64_t i) {
+    return i * 0x9E3779B97F4A7C15ULL;
+}
+
+typedef struct BenchResult {
+    double insert_ms;
+    double hit_ms;
+    double miss_ms;
+    double teardown_ms;
+    uint64_t checksum;
+} BenchResult;
+
+static BenchResult bench_arena_map(Arena* arena) {
+    BenchResult result = {0};
+    double start = now_ms();
+    BenchMap* map = BenchMap_create(arena, 0);
+    map->rewind_on_rehash = true;
+    for (uint64_t i = 0; i < BENCH_KEYS; i++) {
+        map->put(map->self, bench_key(i), i);
+    }
+    result.insert_ms = now_ms() - start;
+
+    start = now_ms();
+    for (uint64_t i = 0; i < BENCH_KEYS; i++) {
+        result.checksum += *map->get(map->self, bench_key(i));
+    }
+    result.hit_ms = now_ms() - start;
+
+    start = now_ms();
+    for (uint64_t i = BENCH_KEYS; i < 2 * BENCH_KEYS; i++) {
+        result.checksum += map->get(map->self, bench_key(i)) != NULL;
+    }
+    result.miss_ms = now_ms() - start;
+
+    start = now_ms();
+    arena->reset(arena->self);
+    result.teardown_ms = now_ms() - start;
+    return result;
+}
+
+static BenchResult bench_malloc_map(void) {
+    BenchResult result = {0};
+    MallocMap map;
+    double start = now_ms();
+    malloc_map_init(&map);
+    for (uint64_t i = 0; i < BENCH_KEYS; i++) {
+        malloc_map_put(&map, bench_key(i), i);
+    }
+    result.insert_ms = now_ms() - start;
+
+    start = now_ms();
+    for (uint64_t i = 0; i < BENCH_KEYS; i++) {
+        result.checksum += *malloc_map_get(&map, bench_key(i));
+    }
+    result.hit_ms = now_ms() - start;
+
+    start = now_ms();
+    for (uint64_t i = BENCH_KEYS; i < 2 * BENCH_KEYS; i++) {
+        result.checksum += malloc_map_get(&map, bench_key(i)) != NULL;
+    }
+    result.miss_ms = now_ms() - start;
+
+    start = now_ms();
+    malloc_map_free(&map);
+    result.teardown_ms = now_ms() - start;
+    return result;
+}
+
+static void print_result(const char* name, BenchResult result) {
+    printf("  %-12s insert %8.2f ms  hit %8.2f ms  miss %8.2f ms  teardown %8.2f ms\n",
+           name, result.insert_ms, result.hit_ms, result.miss_ms, result.teardown_ms);
+}
+
+void bench_hash_map(void) {
+    printf("=== Hash Map: %d u64 keys, best of %d rounds ===\n", BENCH_KEYS, BENCH_ROUNDS);
+    Arena* arena = Arena_create(64 * 1024 * 1024);
+
+    BenchResult best_arena = {0};
+    BenchResult best_malloc = {0};
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        BenchResult a = bench_arena_map(arena);
+        BenchResult m = bench_malloc_map();
+        if (a.checksum != m.checksum) {
+            printf("  checksum mismatch: %llu vs %llu\n",
+                   (unsigned long long)a.checksum, (unsigned long long)m.checksum);
+        }
+        if (round == 0 || a.insert_ms + a.hit_ms + a.miss_ms + a.teardown_ms <
+                              best_arena.insert_ms + best_arena.hit_ms + best_arena.miss_ms + best_arena.teardown_ms) {
+            best_arena = a;
+        }
+        if (round == 0 || m.insert_ms + m.hit_ms + m.miss_ms + m.teardown_ms <
+                              best_malloc.insert_ms + best_malloc.hit_ms + best_malloc.miss_ms + best_malloc.teardown_ms) {
+            best_malloc = m;
+        }
+    }
+
+    print_result("ArenaMap", best_arena);
+    print_result("malloc map", best_malloc);
+    printf("\n");
+
+    arena->destroy(arena->self);
+}
+
+static double bench_bump(Arena* arena, bool aligned, uint64_t* checksum) {
+    double start = now_ms();
+    for (uint64_t i = 0; i < BENCH_BUMP_ALLOCS; i++) {
+        if ((i & 4095) == 0) {
+            arena->reset(arena->self);
+        }
+        size_t size = 8 + (size_t)((i * 7) & 56);
+        uint8_t* ptr = aligned ? (uint8_t*)arena->alloc_aligned(arena->self, size, 16)
+                               : (uint8_t*)arena->alloc(arena->self, size);
+        ptr[0] = (uint8_t)i;
+        *checksum += (uintptr_t)ptr & 15;
+    }
+    return now_ms() - start;
+}
+
+void bench_bump_direction(void) {
+    printf("=== Bump Direction: %d allocations of 8-64 bytes, reset every 4096, best of %d rounds ===\n",
+           BENCH_BUMP_ALLOCS, BENCH_ROUNDS);
+    Arena* up = Arena_create(512 * 1024);
+    Arena* down = Arena_create_bump_down(512 * 1024);
+
+    const char* names[2] = {"alloc", "alloc_aligned"};
+    for (int aligned = 0; aligned < 2; aligned++) {
+        double best_up = 0.0;
+        double best_down = 0.0;
+        uint64_t checksum = 0;
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            double u = bench_bump(up, aligned, &checksum);
+            double d = bench_bump(down, aligned, &checksum);
+            if (round == 0 || u < best_up) {
+                best_up = u;
+            }
+            if (round == 0 || d < best_down) {
+                best_down = d;
+            }
+        }
+        printf("  %-14s up %8.2f ms (%5.2f ns/op)  down %8.2f ms (%5.2f ns/op)\n", names[aligned],
+               best_up, best_up * 1e6 / BENCH_BUMP_ALLOCS,
+               best_down, best_down * 1e6 / BENCH_BUMP_ALLOCS);
+    }
+    printf("\n");
+
+    up->destroy(up->self);
+    down->destroy(down->self);
+}
+
+int main(void) {
+    bench_hash_map();
+    bench_bump_direction();
+    return 0;
+}
@@ -1,6 +1,8 @@
 #define ARENA_IMPLEMENTATION
 #include "arena.h"
 
+ARENA_MAP_DEFINE(WordCounts, const char*, int, arena_hash_str, arena_str_eq)
+
 void basic_usage(void) {
     printf("=== Basic Usage ===\n");
     Arena* arena = Arena_create(4096);
@@ -48,6 +50,9 @@ void automatic_growth(void) {
     char* large = (char*)arena->alloc(arena->self, 2048);
     printf("Allocated 2048 bytes (triggers growth)\n");
 
+    char* more = (char*)arena->alloc(arena->self, 300);
+    printf("Next 300 bytes still fill the first chunk: %s\n", more == small + 500 ? "yes" : "no");
+
     arena->print_stats(arena->self);
 
     arena->destroy(arena->self);
@@ -179,21 +184,754 @@ void string_builder_pattern(void) {
 
 void resize_arena(void) {
     printf("=== Manual Resize ===\n");
+    const char* paths[] = {"failed", "in place", "committed", "appended"};
     Arena* arena = Arena_create(1024);
 
     printf("Initial size: %zu bytes\n", arena->self->size);
 
-    arena->alloc(arena->self, 500);
+    char* text = (char*)arena->alloc(arena->self, 500);
+    strcpy(text, "still here");
     printf("Allocated 500 bytes\n");
 
-    if (arena->resize(arena->self, 4096)) {
-        printf("Resized to 4096 bytes\n");
-        printf("New size: %zu bytes\n\n", arena->self->size);
+    ArenaResizeResult result = arena->resize(arena->self, 4096);
+    printf("Resize to 4096 on the heap: %s, first chunk %zu bytes, data %s\n",
+           paths[result], arena->self->size, text);
+    arena->destroy(arena->self);
+
+    Arena* reserved = Arena_create_reserved(1024, 1024 * 1024);
+    text = (char*)reserved->alloc(reserved->self, 500);
+    strcpy(text, "still here");
+    result = reserved->resize(reserved->self, 64 * 1024);
+    printf("Resize to 64K in a 1M reservation: %s, size %zu bytes, data %s\n",
+           paths[result], reserved->self->size, text);
+    reserved->destroy(reserved->self);
+
+    ArenaBacking mapped = arena_backing_mmap();
+    Arena* growing[] = {Arena_create_reserved(1024, 1024 * 1024), Arena_create_ex(1024, 1024 * 1024, &mapped)};
+    for (int i = 0; i < 2; i++) {
+        Arena* grown = growing[i];
+        char* keep = (char*)grown->alloc(grown->self, 64);
+        strcpy(keep, "kept");
+        size_t mark = grown->get_mark(grown->self);
+        grown->alloc(grown->self, 8 * 1024 * 1024);
+        grown->reset_to_mark(grown->self, mark);
+        mark = grown->get_mark(grown->self);
+        grown->alloc(grown->self, 3000);
+        grown->reset_to_mark(grown->self, mark);
+        char* next = (char*)grown->alloc(grown->self, 64);
+        printf("%s: marks survive in-place growth, next block %s, data %s\n",
+               i == 0 ? "Reserved" : "mmap backing", next == keep ? "reuses live data" : "is fresh", keep);
+        grown->destroy(grown->self);
+    }
+    printf("\n");
+}
+
+void hash_map(void) {
+    printf("=== Hash Map ===\n");
+    Arena* arena = Arena_create(4096);
+
+    const char* words[] = {"arena", "map", "arena", "probe", "map", "arena"};
+    WordCounts* counts = WordCounts_create(arena, 4);
+    counts->rewind_on_rehash = true;
+
+    for (int i = 0; i < 6; i++) {
+        int* count = counts->get(counts->self, words[i]);
+        if (count) {
+            (*count)++;
+        } else {
+            counts->put(counts->self, words[i], 1);
+        }
+    }
+
+    size_t cursor = 0;
+    WordCounts_entry* entry;
+    while ((entry = counts->next(counts->self, &cursor)) != NULL) {
+        printf("  %s: %d\n", entry->key, entry->value);
+    }
+
+    counts->remove(counts->self, "probe");
+    printf("Entries after remove: %zu (capacity %zu)\n\n", counts->count, counts->capacity);
+
+    arena->destroy(arena->self);
+}
+
+#ifdef __cplusplus
+void hash_map_cpp(void) {
+    printf("=== Hash Map (C++) ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    ArenaHashMap<uint32_t, uint32_t> squares(arena, 4, true);
+    size_t initial_capacity = squares.capacity();
+    for (uint32_t i = 0; i < 1000; i++) {
+        squares.insert(i, i * i);
+    }
+    printf("Inserted %zu entries, capacity grew from %zu to %zu\n", squares.size(), initial_capacity,
+           squares.capacity());
+
+    uint32_t* square = squares.find(31);
+    printf("find(31) = %u, find(5000) = %s\n", square ? *square : 0, squares.find(5000) ? "found" : "missing");
+
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        squares.erase(i);
+    }
+    uint64_t sum = 0;
+    for (ArenaHashMap<uint32_t, uint32_t>::iterator it = squares.begin(); it != squares.end(); ++it) {
+        sum += it->value;
+    }
+    printf("After erasing even keys: %zu entries, contains(2) = %s, sum of odd squares = %llu\n\n",
+           squares.size(), squares.contains(2) ? "true" : "false", (unsigned long long)sum);
+
+    arena->destroy(arena->self);
+}
+#endif
+
+typedef struct GraphNode {
+    int id;
+    struct GraphNode* parent;
+} GraphNode;
+
+void segmented_list(void) {
+    printf("=== Segmented List ===\n");
+    Arena* arena = Arena_create(4096);
+
+    ArenaSegList* nodes = ArenaSegList_create(arena, sizeof(GraphNode), 8, 4);
+    GraphNode* root = (GraphNode*)nodes->push(nodes->self, NULL);
+    root->id = 0;
+    root->parent = NULL;
+
+    for (int i = 1; i < 100; i++) {
+        GraphNode* node = (GraphNode*)nodes->push(nodes->self, NULL);
+        node->id = i;
+        node->parent = root;
+    }
+
+    printf("Root pointer still valid after 100 pushes: %s\n",
+           ARENA_SEGLIST_AT(nodes, GraphNode, 0) == root ? "Yes" : "No");
+    printf("Node 57 id: %d\n", ARENA_SEGLIST_AT(nodes, GraphNode, 57)->id);
+
+    for (size_t s = 0; s < nodes->segment_count; s++) {
+        size_t length;
+        nodes->segment(nodes->self, s, &length);
+        printf("  Segment %zu: %zu nodes\n", s, length);
+    }
+    printf("\n");
+
+    arena->destroy(arena->self);
+}
+
+typedef struct Connection {
+    int fd;
+    char peer[32];
+} Connection;
+
+void object_pool(void) {
+    printf("=== Object Pool ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    ArenaPool* pool = ArenaPool_create(arena, sizeof(Connection), 64);
+    Connection* open_conns[16];
+
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 16; i++) {
+            open_conns[i] = (Connection*)pool->alloc(pool->self);
+            open_conns[i]->fd = round * 16 + i;
+            sprintf(open_conns[i]->peer, "10.0.0.%d", i);
+        }
+        for (int i = 0; i < 16; i++) {
+            pool->free(pool->self, open_conns[i]);
+        }
+    }
+    printf("1600 connections opened and closed\n");
+
+    pool->print_stats(pool->self);
+
+    arena->destroy(arena->self);
+}
+
+void slab_allocator(void) {
+    printf("=== Slab Allocator ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    ArenaSlab* slab = ArenaSlab_create(arena, 0);
+
+    char* name = (char*)slab->alloc(slab->self, 24);
+    sprintf(name, "session-42");
+    double* samples = (double*)slab->alloc(slab->self, sizeof(double) * 100);
+    samples[99] = 3.5;
+
+    slab->free(slab->self, samples, sizeof(double) * 100);
+    double* reused = (double*)slab->alloc(slab->self, sizeof(double) * 105);
+    printf("Freed 800-byte block reused by 840-byte request: %s\n",
+           (void*)reused == (void*)samples ? "Yes" : "No");
+
+    name = (char*)slab->realloc(slab->self, name, 24, 200);
+    printf("Grown string: %s\n", name);
+
+    slab->print_stats(slab->self);
+
+    arena->destroy(arena->self);
+}
+
+void tlsf_heap(void) {
+    printf("=== TLSF Heap ===\n");
+    Arena* arena = Arena_create(256 * 1024);
+
+    ArenaTlsf* heap = ArenaTlsf_create(arena, 128 * 1024);
+
+    float* left = (float*)heap->alloc(heap->self, sizeof(float) * 512);
+    float* right = (float*)heap->alloc(heap->self, sizeof(float) * 512);
+    char* label = (char*)heap->alloc(heap->self, 40);
+    sprintf(label, "stereo buffer");
+
+    heap->free(heap->self, left);
+    heap->free(heap->self, right);
+    float* joined = (float*)heap->alloc(heap->self, sizeof(float) * 1024);
+    printf("Freed neighbours coalesced into one block: %s\n", joined == left ? "Yes" : "No");
+
+    label = (char*)heap->realloc(heap->self, label, 400);
+    printf("Label after realloc: %s\n", label);
+
+    heap->print_stats(heap->self);
+
+    arena->destroy(arena->self);
+}
+
+void buddy_allocator(void) {
+    printf("=== Buddy Allocator ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    ArenaBuddy* blocks = ArenaBuddy_create(arena, 4096, 1024 * 1024);
+
+    void* io_small = blocks->alloc(blocks->self, 4096);
+    void* io_large = blocks->alloc(blocks->self, 100 * 1024);
+    printf("128 KiB block naturally aligned: %s\n",
+           ((uintptr_t)io_large % (128 * 1024) == 0) ? "Yes" : "No");
+
+    blocks->print_stats(blocks->self);
+
+    blocks->free(blocks->self, io_small);
+    blocks->free(blocks->self, io_large);
+    printf("After freeing both, blocks merged back into %zu byte region: %s\n\n",
+           blocks->max_block, blocks->free_lists[blocks->max_order] ? "Yes" : "No");
+
+    arena->destroy(arena->self);
+}
+
+void consume_message(ArenaSlab* slab, char* message) {
+    printf("  Consumed: %s\n", message);
+    slab->remote_free(slab->self, message, 64);
+}
+
+void remote_free_queue(void) {
+    printf("=== Remote Free Queue ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    ArenaSlab* slab = ArenaSlab_create(arena, 0);
+    char* first = (char*)slab->alloc(slab->self, 64);
+    sprintf(first, "message 1");
+    char* second = (char*)slab->alloc(slab->self, 64);
+    sprintf(second, "message 2");
+
+    consume_message(slab, first);
+    consume_message(slab, second);
+
+    ArenaPool* pool = slab->classes[3];
+    char* recycled = (char*)slab->alloc(slab->self, 64);
+    printf("Owner reclaimed remote frees on its next allocation: %s (%zu drained)\n\n",
+           (recycled == first || recycled == second) ? "Yes" : "No", pool->remote_drained);
+
+    arena->destroy(arena->self);
+}
+
+void realloc_hole_reuse(void) {
+    printf("=== Realloc Hole Reuse ===\n");
+    Arena* arena = Arena_create(4096);
+
+    char* line = (char*)arena->alloc(arena->self, 64);
+    sprintf(line, "GET /index.html");
+    char* header = (char*)arena->alloc(arena->self, 32);
+    sprintf(header, "Host: example.com");
+
+    char* old_line = line;
+    line = (char*)arena->realloc(arena->self, line, 64, 256);
+    strcat(line, " HTTP/1.1");
+
+    char* small = (char*)arena->alloc(arena->self, 48);
+    printf("48-byte allocation reused the abandoned 64-byte block: %s\n",
+           small == old_line ? "Yes" : "No");
+    printf("%s / %s\n", line, header);
+
+    arena->print_stats(arena->self);
+
+    arena->destroy(arena->self);
+}
+
+void double_ended(void) {
+    printf("=== Double-Ended Arena ===\n");
+    Arena* level = Arena_create(16 * 1024);
+
+    int* tiles = (int*)level->alloc(level->self, sizeof(int) * 1024);
+    tiles[0] = 7;
+    printf("Level data at the bottom: %zu bytes\n", level->get_mark(level->self));
+
+    size_t temp_mark = level->get_high_mark(level->self);
+    for (int pass = 0; pass < 3; pass++) {
+        char* scratch = (char*)level->alloc_high_aligned(level->self, 2048, 16);
+        sprintf(scratch, "decompression pass %d", pass);
+        printf("  %s (top end: %zu bytes)\n", scratch, level->get_high_mark(level->self));
+    }
+    level->reset_high_to_mark(level->self, temp_mark);
+
+    printf("Temporaries released, level data intact: %d\n\n", tiles[0]);
+
+    level->destroy(level->self);
+}
+
+bool gpu_done(void* user, uint64_t frame) {
+    uint64_t* completed = (uint64_t*)user;
+    return *completed >= frame;
+}
+
+typedef struct Station {
+    struct Station* next;
+    const char* name;
+} Station;
+
+void snapshot_image(void) {
+    printf("=== Snapshot Save/Load ===\n");
+    Arena* arena = Arena_create(1024);
+
+    const char* names[] = {"Alpha", "Bravo", "Charlie"};
+    Station* list = NULL;
+    for (int i = 0; i < 3; i++) {
+        Station* station = (Station*)arena->alloc_aligned(arena->self, sizeof(Station), sizeof(void*));
+        char* name = (char*)arena->alloc(arena->self, strlen(names[i]) + 1);
+        strcpy(name, names[i]);
+        station->name = name;
+        station->next = list;
+        arena_snapshot_add_pointer(arena, &station->name);
+        arena_snapshot_add_pointer(arena, &station->next);
+        list = station;
+    }
+
+    arena_snapshot_save(arena, list, "example_snapshot.bin");
+    arena->destroy(arena->self);
+
+    Station* loaded = NULL;
+    Arena* image = Arena_create_from_snapshot("example_snapshot.bin", (void**)&loaded);
+    printf("Loaded %zu bytes, %zu pointers fixed up:", image->offset, image->snapshot_relocations);
+    for (Station* station = loaded; station; station = station->next) {
+        printf(" %s", station->name);
+    }
+    printf("\n\n");
+
+    image->destroy(image->self);
+    remove("example_snapshot.bin");
+}
+
+typedef struct RelStation {
+    ARENA_REL_PTR(struct RelStation) next;
+    ARENA_REL_PTR(char) name;
+} RelStation;
+
+void relative_pointers(void) {
+    printf("=== Self-Relative Pointers ===\n");
+    Arena* arena = Arena_create_contiguous(256, 1024 * 1024);
+
+    const char* names[] = {"Delta", "Echo", "Foxtrot"};
+    RelStation* list = NULL;
+    for (int i = 0; i < 3; i++) {
+        RelStation* station = (RelStation*)arena->alloc_aligned(arena->self, sizeof(RelStation), sizeof(void*));
+        char* name = (char*)arena->alloc(arena->self, strlen(names[i]) + 1);
+        strcpy(name, names[i]);
+        ARENA_REL_SET(station->name, name);
+        ARENA_REL_SET(station->next, list);
+        list = station;
+    }
+
+    size_t list_offset = (size_t)((uint8_t*)list - (uint8_t*)arena->self->memory);
+    arena->resize(arena->self, 64 * 1024);
+    printf("After resize:");
+    for (RelStation* station = list; station; station = ARENA_REL_GET(RelStation, station->next)) {
+        printf(" %s", ARENA_REL_GET(char, station->name));
+    }
+    printf("\n");
+
+    uint8_t* copy = (uint8_t*)malloc(arena->self->offset);
+    memcpy(copy, arena->self->memory, arena->self->offset);
+    printf("In a copy:   ");
+    for (RelStation* station = (RelStation*)(copy + list_offset); station;
+         station = ARENA_REL_GET(RelStation, station->next)) {
+        printf(" %s", ARENA_REL_GET(char, station->name));
+    }
+    printf("\n\n");
+
+    free(copy);
+    arena->destroy(arena->self);
+}
+
+typedef struct HandleNode {
+    ArenaHandle left;
+    ArenaHandle right;
+    uint32_t key;
+} HandleNode;
+
+static ArenaHandle handle_insert(Arena* arena, ArenaHandle root, uint32_t key) {
+    HandleNode* node = (HandleNode*)arena->alloc_aligned(arena->self, sizeof(HandleNode), 4);
+    node->left = ARENA_HANDLE_NULL;
+    node->right = ARENA_HANDLE_NULL;
+    node->key = key;
+    ArenaHandle handle = arena_handle_encode(arena, node, 2);
+    if (!root) {
+        return handle;
+    }
+
+    HandleNode* current = ARENA_HANDLE_DECODE(HandleNode, arena, root, 2);
+    for (;;) {
+        ArenaHandle* link = key < current->key ? &current->left : &current->right;
+        if (!*link) {
+            *link = handle;
+            return root;
+        }
+        current = ARENA_HANDLE_DECODE(HandleNode, arena, *link, 2);
+    }
+}
+
+void compressed_handles(void) {
+    printf("=== Compressed Handles ===\n");
+    Arena* arena = Arena_create_contiguous(64, 1024 * 1024);
+
+    ArenaHandle root = ARENA_HANDLE_NULL;
+    for (uint32_t i = 0; i < 1000; i++) {
+        root = handle_insert(arena, root, (i * 7919 + 500) % 1000);
+    }
+
+    uint32_t depth = 0;
+    for (ArenaHandle h = root; h; h = ARENA_HANDLE_DECODE(HandleNode, arena, h, 2)->left) {
+        depth++;
+    }
+    printf("1000 nodes of %zu bytes in one %zu byte block, leftmost path %u nodes\n\n",
+           sizeof(HandleNode), arena->self->size, depth);
+
+    arena->destroy(arena->self);
+}
+
+void persistent_file(void) {
+    printf("=== File-Backed Arena ===\n");
+    const char* names[] = {"Golf", "Hotel", "India"};
+
+    Arena* arena = Arena_open_file("example_arena.bin", 4096, 1024 * 1024);
+    if (!arena) {
+        printf("File-backed arenas are not available on this platform\n\n");
+        return;
+    }
+    RelStation* list = NULL;
+    for (int i = 0; i < 3; i++) {
+        RelStation* station = (RelStation*)arena->alloc_aligned(arena->self, sizeof(RelStation), sizeof(void*));
+        char* name = (char*)arena->alloc(arena->self, strlen(names[i]) + 1);
+        strcpy(name, names[i]);
+        ARENA_REL_SET(station->name, name);
+        ARENA_REL_SET(station->next, list);
+        list = station;
+    }
+    arena_file_set_root(arena, list);
+    arena_sync(arena, NULL, 0);
+    arena->destroy(arena->self);
+
+    Arena* reopened = Arena_open_file("example_arena.bin", 4096, 1024 * 1024);
+    printf("Reopened with %zu bytes used:", reopened->offset);
+    for (RelStation* station = (RelStation*)arena_file_root(reopened); station;
+         station = ARENA_REL_GET(RelStation, station->next)) {
+        printf(" %s", ARENA_REL_GET(char, station->name));
+    }
+    printf("\n\n");
+
+    reopened->destroy(reopened->self);
+    remove("example_arena.bin");
+}
+
+void shared_arena(void) {
+    printf("=== Shared Arena ===\n");
+    ArenaShared* shared = ArenaShared_create("/arena-example", 64 * 1024);
+    if (!shared) {
+        printf("Shared arenas are not available on this platform\n\n");
+        return;
     }
+    ArenaShared* view = ArenaShared_open("/arena-example");
+    ArenaShared_unlink("/arena-example");
+
+    char* message = (char*)shared->alloc(shared->self, 32);
+    strcpy(message, "written by the producer");
+    ArenaSharedOffset handoff = shared->to_offset(shared->self, message);
+
+    printf("Offset %llu read through a second mapping: %s\n", (unsigned long long)handoff,
+           (char*)view->from_offset(view->self, handoff));
+    printf("Same address in both mappings: %s\n\n",
+           (void*)message == view->from_offset(view->self, handoff) ? "yes" : "no");
+
+    view->destroy(view->self);
+    shared->destroy(shared->self);
+}
+
+void copy_on_write_fork(void) {
+    printf("=== Copy-on-Write Fork ===\n");
+    Arena* state = Arena_create_forkable(1024 * 1024, 16 * 1024 * 1024);
+    if (!state) {
+        printf("Forkable arenas are not available on this platform\n\n");
+        return;
+    }
+
+    int* board = (int*)state->alloc(state->self, 1024 * 1024 - 4096);
+    for (int i = 0; i < 64; i++) {
+        board[i] = i;
+    }
+    arena_file_set_root(state, board);
+
+    Arena* branch = arena_fork(state);
+    int* branch_board = (int*)arena_file_root(branch);
+    branch_board[0] = 100;
+    board[1] = 200;
+
+    printf("Parent: %d %d %d\n", board[0], board[1], board[2]);
+    printf("Branch: %d %d %d\n\n", branch_board[0], branch_board[1], branch_board[2]);
+
+    branch->destroy(branch->self);
+    state->destroy(state->self);
+}
+
+void frozen_arena(void) {
+    printf("=== Frozen Arena ===\n");
+    Arena* arena = Arena_create(64 * 1024);
+
+    int* squares = (int*)arena->alloc(arena->self, sizeof(int) * 1000);
+    for (int i = 0; i < 1000; i++) {
+        squares[i] = i * i;
+    }
+
+    arena_freeze(arena, false);
+    printf("Frozen, squares[999] is still readable: %d\n", squares[999]);
+    printf("Allocating after the freeze returns %s\n\n",
+           arena->alloc(arena->self, 16) ? "a block" : "NULL");
 
     arena->destroy(arena->self);
 }
 
+void incremental_checkpoint(void) {
+    printf("=== Incremental Checkpoint ===\n");
+    Arena* arena = Arena_create_reserved(4 * 1024 * 1024, 16 * 1024 * 1024);
+    uint8_t* grid = (uint8_t*)arena->alloc(arena->self, 2 * 1024 * 1024);
+    memset(grid, 0, 2 * 1024 * 1024);
+    uint8_t* history = (uint8_t*)arena->alloc(arena->self, 8 * 1024 * 1024);
+    history[0] = 3;
+
+    ArenaCheckpoint* checkpoint = ArenaCheckpoint_create(arena, "example_checkpoint.bin", ARENA_CHECKPOINT_AUTO);
+    if (!checkpoint) {
+        printf("Checkpoints are not available on this platform\n\n");
+        arena->destroy(arena->self);
+        return;
+    }
+
+    checkpoint->save(checkpoint->self);
+    checkpoint->save(checkpoint->self);
+    size_t first = checkpoint->pages_written;
+    grid[0] = 1;
+    grid[1024 * 1024] = 2;
+    checkpoint->save(checkpoint->self);
+    printf("First two saves wrote %zu pages, the next one %zu\n", first, checkpoint->pages_written - first);
+    checkpoint->destroy(checkpoint->self);
+
+    Arena* recovered = Arena_create_from_checkpoint("example_checkpoint.bin");
+    uint8_t* restored = (uint8_t*)recovered->memory;
+    ArenaHuge* huge = (ArenaHuge*)recovered->huge;
+    printf("Recovered %zu bytes, cells: %d %d, %zu huge region with history %d\n", recovered->offset,
+           restored[0], restored[1024 * 1024], recovered->huge_count, ((uint8_t*)huge + huge->header)[0]);
+
+    ArenaCheckpoint* resumed = ArenaCheckpoint_create(recovered, "example_checkpoint.bin", ARENA_CHECKPOINT_AUTO);
+    Arena* unsaved = Arena_create_from_checkpoint("example_checkpoint.bin");
+    restored[0] = 4;
+    resumed->save(resumed->self);
+    resumed->destroy(resumed->self);
+    Arena* resaved = Arena_create_from_checkpoint("example_checkpoint.bin");
+    printf("Resumed checkpointing: old image %s before the first save, cell %d after it\n",
+           unsaved ? "still loads" : "was lost", ((uint8_t*)resaved->memory)[0]);
+    if (unsaved) {
+        unsaved->destroy(unsaved->self);
+    }
+    resaved->destroy(resaved->self);
+
+    recovered->destroy(recovered->self);
+    arena->destroy(arena->self);
+    remove("example_checkpoint.bin");
+
+    Arena* scratch = Arena_create(16 * 1024);
+    scratch->alloc(scratch->self, 10 * 1024);
+    size_t mark = scratch->get_mark(scratch->self);
+    scratch->alloc(scratch->self, 8 * 1024);
+    ArenaCheckpoint* full = ArenaCheckpoint_create(scratch, "example_marks.bin", ARENA_CHECKPOINT_FULL);
+    full->save(full->self);
+    full->destroy(full->self);
+    Arena* copy = Arena_create_from_checkpoint("example_marks.bin");
+    printf("Round trip: mark %zu vs %zu", scratch->get_mark(scratch->self), copy->get_mark(copy->self));
+    scratch->alloc(scratch->self, 100);
+    copy->alloc(copy->self, 100);
+    printf(", after a small alloc %zu vs %zu", scratch->get_mark(scratch->self), copy->get_mark(copy->self));
+    scratch->reset_to_mark(scratch->self, mark);
+    copy->reset_to_mark(copy->self, mark);
+    printf(", reset_to_mark(%zu) gives %zu vs %zu\n\n", mark, scratch->get_mark(scratch->self),
+           copy->get_mark(copy->self));
+    copy->destroy(copy->self);
+    scratch->destroy(scratch->self);
+    remove("example_marks.bin");
+}
+
+static void* parent_reserve(void* ctx, size_t size) {
+    Arena* parent = (Arena*)ctx;
+    return parent->alloc_aligned(parent->self, size, 64);
+}
+
+static void parent_release(void* ctx, void* memory, size_t size) {
+    (void)ctx;
+    (void)memory;
+    (void)size;
+}
+
+void custom_backing(void) {
+    printf("=== Custom Backing Allocator ===\n");
+    static uint8_t buffer[64 * 1024];
+    ArenaStaticBacking state;
+    ArenaBacking fixed = arena_backing_static(&state, buffer, sizeof(buffer));
+    Arena* arena = Arena_create_ex(4096, 0, &fixed);
+
+    for (int i = 0; i < 8; i++) {
+        arena->alloc(arena->self, 2048);
+    }
+    printf("Static buffer: 16KB allocated, %zu of %zu buffer bytes handed out, %s\n", state.used, state.size,
+           arena->alloc(arena->self, 64 * 1024) ? "overflow allocated" : "overflow refused");
+    arena->destroy(arena->self);
+    printf("After destroy the buffer is empty again: %zu bytes in use\n", state.used);
+
+    ArenaBacking mapped = arena_backing_mmap();
+    Arena* reserved = Arena_create_ex(64 * 1024, 16 * 1024 * 1024, &mapped);
+    reserved->alloc(reserved->self, 1024 * 1024);
+    printf("mmap backing: grew to %zu bytes inside one %zu byte reservation\n", reserved->size, reserved->reserved);
+    reserved->destroy(reserved->self);
+
+    Arena* parent = Arena_create(1024 * 1024);
+    ArenaBacking nested = {parent_reserve, NULL, parent_release, parent};
+    Arena* child = Arena_create_ex(8192, 0, &nested);
+    for (int i = 0; i < 100; i++) {
+        child->alloc(child->self, 256);
+    }
+    printf("Arena on arena: child chunks carved from the parent, parent used %zu bytes\n\n",
+           parent->get_mark(parent->self));
+    child->destroy(child->self);
+    parent->destroy(parent->self);
+}
+
+void adaptive_sizing(void) {
+    printf("=== Adaptive Sizing ===\n");
+    static ArenaSiteProfile request_site = ARENA_SITE_PROFILE("request");
+
+    for (int instance = 0; instance < 2; instance++) {
+        Arena* arena = Arena_create_adaptive(1024, &request_site);
+        printf("Instance %d starts with %zu bytes\n", instance + 1, arena->size);
+        for (int cycle = 0; cycle < 3; cycle++) {
+            for (int i = 0; i < 200; i++) {
+                arena->alloc(arena->self, 64);
+            }
+            arena->reset(arena->self);
+        }
+        printf("  after 3 cycles: %zu bytes, %s\n", arena->size, arena->next ? "chained" : "single chunk");
+        arena->destroy(arena->self);
+    }
+    printf("\n");
+}
+
+void retention_policy(void) {
+    printf("=== Retention Policy ===\n");
+    Arena* arena = Arena_create(4096);
+    arena->retain_target = 8192;
+    arena->retain_decay_resets = 2;
+
+    for (int i = 0; i < 1000; i++) {
+        arena->alloc(arena->self, 128);
+    }
+
+    for (int cycle = 0; cycle < 4; cycle++) {
+        arena->reset(arena->self);
+        arena->alloc(arena->self, 128);
+        printf("Reset %d: retention limit %zu bytes, %zu bytes released so far\n",
+               cycle + 1, arena->retain_limit, arena->released_bytes);
+    }
+    printf("\n");
+
+    arena->destroy(arena->self);
+}
+
+void huge_allocations(void) {
+    printf("=== Huge Allocations ===\n");
+    Arena* arena = Arena_create(4096);
+
+    size_t mark = arena->get_mark(arena->self);
+    size_t bytes = 8 * 1024 * 1024;
+    uint8_t* image = (uint8_t*)arena->alloc(arena->self, bytes);
+    memset(image, 0xff, bytes);
+    image = (uint8_t*)arena->realloc(arena->self, image, bytes, bytes * 2);
+    printf("Image buffer: %zu bytes in %zu mapped region(s), still %s\n",
+           bytes * 2, arena->huge_count, image[bytes - 1] == 0xff ? "intact" : "corrupt");
+
+    arena->reset_to_mark(arena->self, mark);
+    printf("After reset_to_mark: %zu mapped region(s), %zu chunk bytes\n\n",
+           arena->huge_count, arena->size);
+
+    arena->destroy(arena->self);
+}
+
+void bump_down(void) {
+    printf("=== Bump-Down Arena ===\n");
+    Arena* arena = Arena_create_bump_down(4096);
+
+    float* a = (float*)arena->alloc_aligned(arena->self, sizeof(float) * 10, 16);
+    float* b = (float*)arena->alloc_aligned(arena->self, sizeof(float) * 10, 16);
+    printf("Second block sits below the first: %s\n", b < a ? "yes" : "no");
+
+    b[0] = 1.5f;
+    b = (float*)arena->realloc(arena->self, b, sizeof(float) * 10, sizeof(float) * 20);
+    printf("Grown in place downward, contents kept: %.1f\n", b[0]);
+
+    size_t mark = arena->get_mark(arena->self);
+    arena->alloc(arena->self, 100);
+    arena->reset_to_mark(arena->self, mark);
+    printf("Used after reset_to_mark: %zu bytes\n\n", arena->get_mark(arena->self));
+
+    arena->destroy(arena->self);
+}
+
+void pipelined_frames(void) {
+    printf("=== Pipelined Frames ===\n");
+    ArenaFrameRing* ring = ArenaFrameRing_create(3, 1024 * 64);
+    uint64_t gpu_completed = 0;
+
+    for (int i = 0; i < 6; i++) {
+        Arena* frame_arena = ring->begin_frame(ring->self);
+        uint64_t frame = ring->frame;
+
+        float* commands = (float*)frame_arena->alloc(frame_arena->self, sizeof(float) * 256);
+        commands[0] = (float)frame;
+        ring->set_fence(ring->self, gpu_done, &gpu_completed);
+
+        printf("  Built frame %llu in arena slot %llu\n",
+               (unsigned long long)frame, (unsigned long long)(frame % ring->count));
+
+        if (frame >= 1) {
+            gpu_completed = frame - 1;
+        }
+    }
+    printf("Frames that had to wait for retirement: %zu\n\n", ring->waits);
+
+    ring->destroy(ring->self);
+}
+
 int main(void) {
     printf("\n");
     printf("╔════════════════════════════════════════╗\n");
@@ -211,6 +949,32 @@ int main(void) {
     game_frame_pattern();
     string_builder_pattern();
     resize_arena();
+    hash_map();
+#ifdef __cplusplus
+    hash_map_cpp();
+#endif
+    segmented_list();
+    object_pool();
+    slab_allocator();
+    tlsf_heap();
+    buddy_allocator();
+    remote_free_queue();
+    realloc_hole_reuse();
+    double_ended();
+    huge_allocations();
+    retention_policy();
+    adaptive_sizing();
+    snapshot_image();
+    relative_pointers();
+    compressed_handles();
+    persistent_file();
+    shared_arena();
+    copy_on_write_fork();
+    frozen_arena();
+    incremental_checkpoint();
+    custom_backing();
+    bump_down();
+    pipelined_frames();
 
     printf("╔════════════════════════════════════════╗\n");
     printf("║          All Examples Complete         ║\n");